@@ -21,6 +21,7 @@ const int MAX_PATH_LENGTH = 59; // Maximum allowed path length to avoid infinite
 const int MAX_PATHS_TRAVERSED = 20000000; // Maximum number of paths to traverse to avoid excessive computation
 const int INITIAL_DEPTH_LIMIT = 10; // Initial depth limit for IDA*
 const int BEAM_WIDTH = 1000; // Beam width for IDA* with Beam Search
+const int TRANSPOSITION_TABLE_BITS = 21; // IDA* transposition table holds 2^21 entries (40 MB)
 
 std::mutex cout_mutex; // Mutex for thread-safe console output
 
@@ -169,519 +170,5349 @@ struct GameState { // Represents the state of the game at any point
 #include <limits>
 #include <random>
 #include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <csignal>
+#include <cerrno>
+#include <cctype>
+#include <deque>
+#include <set>
+#include <tuple>
+#include <map>
+#include <atomic>
+#include <bit>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <sched.h>
+#include <cmath>
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#endif
 
-struct SolveResult {
-    int paths_traversed;
-    std::vector<std::pair<int, std::string>> solution;
-};
+const int MAX_WORDS = 16; // Word capacity of a packed state (two 64-bit machine words of one-byte cells)
+const int MAX_CELLS = 128; // Cell capacity of a board (10x10 grids use 100)
+const uint8_t NO_CELL = 0xFF; // Marks unused word slots in a packed state
+const int NUM_DIRECTIONS = 4;
+const uint8_t UNREACHABLE = 0xFF; // Slide distance of a cell that can never reach a target
+const int DEAD_STATE_COST = 1000; // Heuristic value of a state from which no goal placement is reachable
+const uint8_t NO_MOVE = 0xFF; // Last move of the root node, which has none to prune against
+const int PLACEMENT_LANE_BLOCK = 16; // Placement cost rows are padded to a multiple of one AVX2 register of int16 lanes
 
-// Forward declarations
-bool has_realizable_path(const Position& start, const Position& goal, const GameState& state);
-bool are_interacting(const Position& pos1, const Position& pos2, const Position& goal1, const Position& goal2);
+bool use_move_pruning = true; // Cleared by the "n" flag to count expansions without move pruning
+unsigned solver_thread_count = 0; // Threads given to the parallel solvers; 0 uses every core
 
-struct VectorPositionHash {
-    std::size_t operator()(const std::vector<Position>& vec) const {
-        std::size_t seed = vec.size();
-        for (const auto& pos : vec) {
-            seed ^= std::hash<int>()(pos.first) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-            seed ^= std::hash<int>()(pos.second) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-        }
-        return seed;
-    }
+const int STATS_MAX_DEPTH = 64; // Buckets of the per-depth expansion histogram; deeper nodes share the last one
+const int STATS_PROBE_BUCKETS = 8; // Hash probe length histogram buckets: 1, 2-3, 4-7, ..., 128 and more
+const int STATS_TIMING_SAMPLE = 64; // One call in this many to the heuristic or the move generator is timed
+const double STATS_REPORT_INTERVAL_SECONDS = 5; // Between the reporter thread's progress lines
+
+// Counters of one thread's work on one search. Only the owning thread writes them, with relaxed load-add-store
+// pairs, so counting takes no lock and no locked instruction; the reporter thread may read them at any time.
+struct StatsBlock {
+    std::atomic<long long> expanded{0};
+    std::atomic<long long> generated{0}; // States produced by the move generators
+    std::atomic<long long> duplicates{0}; // Successors dropped because their state was already reached as cheaply
+    std::atomic<long long> null_moves{0}; // Moves that leave their word in place
+    std::atomic<long long> pruned_moves{0}; // Moves dropped by move pruning for undoing or commuting with the last
+    std::atomic<long long> dead_states{0}; // Successors dropped for leaving a word outside its live cells
+    std::atomic<long long> heuristic_calls{0};
+    std::atomic<long long> heuristic_sampled_ns{0}; // Time spent in the timed calls only
+    std::atomic<long long> move_generation_calls{0};
+    std::atomic<long long> move_generation_sampled_ns{0};
+    std::atomic<long long> open_size{0}; // Open list or frontier size when the search last reported it
+    std::atomic<long long> open_peak{0};
+    std::atomic<long long> table_entries{0}; // Largest hash table sampled or freed: its entries and slots
+    std::atomic<long long> table_slots{0};
+    std::array<std::atomic<long long>, STATS_MAX_DEPTH> depth_expanded{};
+    std::array<std::atomic<long long>, STATS_PROBE_BUCKETS> probe_lengths{};
 };
 
-const std::array<std::pair<std::string, Position>, 4> DIRECTIONS = {{ // Possible movement directions
-    {"up", {-1, 0}},
-    {"down", {1, 0}},
-    {"left", {0, -1}},
-    {"right", {0, 1}}
-}};
+inline void add_count(std::atomic<long long>& counter, long long amount = 1) { // Single-writer increment
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
 
-// Standard heuristic function for A* algorithm
-int standard_heuristic(const GameState& state, const GameState& goal_state) {
-    int total_distance = 0;
-    for (size_t i = 0; i < state.word_positions.size(); ++i) {
-        int min_distance = std::numeric_limits<int>::max();
-        for (const auto& possible_goal : goal_state.word_positions) {
-            int dx = std::abs(state.word_positions[i].first - possible_goal.first);
-            int dy = std::abs(state.word_positions[i].second - possible_goal.second);
-            min_distance = std::min(min_distance, dx + dy);
-        }
-        total_distance += min_distance;
+inline void raise_to(std::atomic<long long>& counter, long long value) { // Single-writer maximum
+    if (value > counter.load(std::memory_order_relaxed)) {
+        counter.store(value, std::memory_order_relaxed);
     }
-    return total_distance;
 }
 
-// Goal state count heuristic
-int goal_count_heuristic(const GameState& state, const GameState& goal_state) {
-    int count = 0;
-    for (size_t i = 0; i < state.word_positions.size(); ++i) {
-        if (std::find(goal_state.word_positions.begin(), goal_state.word_positions.end(), state.word_positions[i]) != goal_state.word_positions.end()) {
-            count++;
+struct SearchStatsSnapshot { // Totals of a search's StatsBlocks at one moment
+    long long expanded = 0;
+    long long generated = 0;
+    long long duplicates = 0;
+    long long null_moves = 0;
+    long long pruned_moves = 0;
+    long long dead_states = 0;
+    long long heuristic_calls = 0;
+    long long heuristic_sampled_ns = 0;
+    long long move_generation_calls = 0;
+    long long move_generation_sampled_ns = 0;
+    long long open_size = 0; // Summed over threads, as are the peaks
+    long long open_peak = 0;
+    long long table_entries = 0;
+    long long table_slots = 0;
+    std::array<long long, STATS_MAX_DEPTH> depth_expanded{};
+    std::array<long long, STATS_PROBE_BUCKETS> probe_lengths{};
+
+    void add(const StatsBlock& block) {
+        auto read = [](const std::atomic<long long>& counter) { return counter.load(std::memory_order_relaxed); };
+        SearchStatsSnapshot other;
+        other.expanded = read(block.expanded);
+        other.generated = read(block.generated);
+        other.duplicates = read(block.duplicates);
+        other.null_moves = read(block.null_moves);
+        other.pruned_moves = read(block.pruned_moves);
+        other.dead_states = read(block.dead_states);
+        other.heuristic_calls = read(block.heuristic_calls);
+        other.heuristic_sampled_ns = read(block.heuristic_sampled_ns);
+        other.move_generation_calls = read(block.move_generation_calls);
+        other.move_generation_sampled_ns = read(block.move_generation_sampled_ns);
+        other.open_size = read(block.open_size);
+        other.open_peak = read(block.open_peak);
+        other.table_entries = read(block.table_entries);
+        other.table_slots = read(block.table_slots);
+        for (int depth = 0; depth < STATS_MAX_DEPTH; ++depth) {
+            other.depth_expanded[depth] = read(block.depth_expanded[depth]);
         }
+        for (int bucket = 0; bucket < STATS_PROBE_BUCKETS; ++bucket) {
+            other.probe_lengths[bucket] = read(block.probe_lengths[bucket]);
+        }
+        merge(other);
     }
-    return state.word_positions.size() - count;
-}
 
-// Number of Realizable Generalized Paths (NRP) heuristic
-int nrp_heuristic(const GameState& state, const GameState& goal_state) {
-    int count = 0;
-    for (size_t i = 0; i < state.word_positions.size(); ++i) {
-        bool has_path = false;
-        for (const auto& goal_pos : goal_state.word_positions) {
-            if (has_realizable_path(state.word_positions[i], goal_pos, state)) {
-                has_path = true;
-                break;
-            }
+    void merge(const SearchStatsSnapshot& other) {
+        expanded += other.expanded;
+        generated += other.generated;
+        duplicates += other.duplicates;
+        null_moves += other.null_moves;
+        pruned_moves += other.pruned_moves;
+        dead_states += other.dead_states;
+        heuristic_calls += other.heuristic_calls;
+        heuristic_sampled_ns += other.heuristic_sampled_ns;
+        move_generation_calls += other.move_generation_calls;
+        move_generation_sampled_ns += other.move_generation_sampled_ns;
+        open_size += other.open_size;
+        open_peak += other.open_peak;
+        if (other.table_entries > table_entries) {
+            table_entries = other.table_entries;
+            table_slots = other.table_slots;
         }
-        if (has_path) {
-            count++;
+        for (int depth = 0; depth < STATS_MAX_DEPTH; ++depth) {
+            depth_expanded[depth] += other.depth_expanded[depth];
+        }
+        for (int bucket = 0; bucket < STATS_PROBE_BUCKETS; ++bucket) {
+            probe_lengths[bucket] += other.probe_lengths[bucket];
         }
     }
-    return state.word_positions.size() - count;
-}
 
-// Linear Conflict heuristic
-int linear_conflict_heuristic(const GameState& state, const GameState& goal_state) {
-    int conflicts = 0;
-    for (size_t i = 0; i < state.word_positions.size(); ++i) {
-        for (size_t j = i + 1; j < state.word_positions.size(); ++j) {
-            if (state.word_positions[i].first == state.word_positions[j].first &&
-                goal_state.word_positions[i].first == goal_state.word_positions[j].first &&
-                (state.word_positions[i].second - state.word_positions[j].second) *
-                    (goal_state.word_positions[i].second - goal_state.word_positions[j].second) < 0) {
-                conflicts += 2;
-            } else if (state.word_positions[i].second == state.word_positions[j].second &&
-                       goal_state.word_positions[i].second == goal_state.word_positions[j].second &&
-                       (state.word_positions[i].first - state.word_positions[j].first) *
-                           (goal_state.word_positions[i].first - goal_state.word_positions[j].first) < 0) {
-                conflicts += 2;
+    static double estimated_seconds(long long calls, long long sampled_ns) { // Scale the timed calls up to all of them
+        long long timed_calls = (calls + STATS_TIMING_SAMPLE - 1) / STATS_TIMING_SAMPLE;
+        return timed_calls ? sampled_ns * 1e-9 * calls / timed_calls : 0;
+    }
+
+    // JSON object of the totals; the histograms are left out of progress lines
+    std::string to_json(bool with_histograms) const {
+        std::ostringstream json;
+        json << std::setprecision(6) << "{\"expanded\": " << expanded << ", \"generated\": " << generated
+             << ", \"duplicates\": " << duplicates << ", \"null_moves\": " << null_moves << ", \"pruned_moves\": " << pruned_moves
+             << ", \"dead_states\": " << dead_states << ", \"open_size\": " << open_size << ", \"open_peak\": " << open_peak
+             << ", \"table_entries\": " << table_entries << ", \"table_slots\": " << table_slots
+             << ", \"heuristic_calls\": " << heuristic_calls
+             << ", \"heuristic_seconds\": " << estimated_seconds(heuristic_calls, heuristic_sampled_ns)
+             << ", \"move_generation_calls\": " << move_generation_calls
+             << ", \"move_generation_seconds\": " << estimated_seconds(move_generation_calls, move_generation_sampled_ns);
+        if (with_histograms) {
+            int depth_count = STATS_MAX_DEPTH;
+            while (depth_count > 0 && depth_expanded[depth_count - 1] == 0) {
+                depth_count--;
             }
+            json << ", \"depth_expanded\": [";
+            for (int depth = 0; depth < depth_count; ++depth) {
+                json << (depth ? ", " : "") << depth_expanded[depth];
+            }
+            json << "], \"probe_lengths\": {";
+            for (int bucket = 0; bucket < STATS_PROBE_BUCKETS; ++bucket) {
+                long long low = 1LL << bucket;
+                json << (bucket ? ", " : "") << "\"" << low
+                     << (bucket == 0 ? "" : bucket == STATS_PROBE_BUCKETS - 1 ? "+" : "-" + std::to_string(2 * low - 1))
+                     << "\": " << probe_lengths[bucket];
+            }
+            json << "}";
         }
+        json << "}";
+        return json.str();
     }
-    return conflicts;
-}
+};
 
-// Manhattan Distance with Sliding heuristic
-int manhattan_sliding_heuristic(const GameState& state, const GameState& goal_state) {
-    int total_distance = 0;
-    for (size_t i = 0; i < state.word_positions.size(); ++i) {
-        int dx = std::abs(goal_state.word_positions[i].first - state.word_positions[i].first);
-        int dy = std::abs(goal_state.word_positions[i].second - state.word_positions[i].second);
-        total_distance += std::max(dx, dy);
+// Statistics of one search, open from its start to its end. Each thread working on the search counts into a
+// StatsBlock of its own, added when it enters a StatsScope. Open searches are listed for the reporter thread.
+class SearchStats;
+std::mutex open_search_stats_mutex;
+std::vector<SearchStats*> open_search_stats;
+
+class SearchStats {
+public:
+    SearchStats(int level, std::string algorithm) : level(level), algorithm(std::move(algorithm)), started_at(std::chrono::steady_clock::now()) {
+        std::lock_guard<std::mutex> lock(open_search_stats_mutex);
+        open_search_stats.push_back(this);
     }
-    return total_distance;
-}
 
-// Interaction Cost heuristic
-int interaction_cost_heuristic(const GameState& state, const GameState& goal_state) {
-    int cost = 0;
-    for (size_t i = 0; i < state.word_positions.size(); ++i) {
-        for (size_t j = i + 1; j < state.word_positions.size(); ++j) {
-            if (are_interacting(state.word_positions[i], state.word_positions[j],
-                                goal_state.word_positions[i], goal_state.word_positions[j])) {
-                cost++;
-            }
-        }
+    ~SearchStats() {
+        std::lock_guard<std::mutex> lock(open_search_stats_mutex);
+        open_search_stats.erase(std::find(open_search_stats.begin(), open_search_stats.end(), this));
     }
-    return cost;
-}
 
-// Helper function for NRP heuristic
-bool has_realizable_path(const Position& start, const Position& goal, const GameState& state) {
-    // Simplified check: consider a path realizable if there are no obstacles in the way
-    int dx = goal.first - start.first;
-    int dy = goal.second - start.second;
-    int steps = std::max(std::abs(dx), std::abs(dy));
-    for (int i = 1; i <= steps; ++i) {
-        int x = start.first + (dx * i) / steps;
-        int y = start.second + (dy * i) / steps;
-        if (state.is_position_occupied({x, y})) {
-            return false;
+    SearchStats(const SearchStats&) = delete;
+    SearchStats& operator=(const SearchStats&) = delete;
+
+    StatsBlock& add_block() {
+        std::lock_guard<std::mutex> lock(blocks_mutex);
+        return blocks.emplace_back();
+    }
+
+    SearchStatsSnapshot snapshot() const {
+        std::lock_guard<std::mutex> lock(blocks_mutex);
+        SearchStatsSnapshot totals;
+        for (const auto& block : blocks) {
+            totals.add(block);
         }
+        return totals;
     }
-    return true;
-}
 
-// Helper function for Interaction Cost heuristic
-bool are_interacting(const Position& pos1, const Position& pos2, const Position& goal1, const Position& goal2) {
-    return pos1.first == pos2.first || pos1.second == pos2.second;
-}
+    const int level;
+    const std::string algorithm;
+    const std::chrono::steady_clock::time_point started_at;
 
-// Combined heuristic function
-int combined_heuristic(const GameState& state, const GameState& goal_state) {
-    return std::max({
-        standard_heuristic(state, goal_state),
-        goal_count_heuristic(state, goal_state),
-        manhattan_sliding_heuristic(state, goal_state),        
-        //interaction_cost_heuristic(state, goal_state),
-        //linear_conflict_heuristic(state, goal_state),
-        //nrp_heuristic(state, goal_state),
-    });
+private:
+    mutable std::mutex blocks_mutex;
+    std::deque<StatsBlock> blocks; // A deque, so blocks never move while their threads count into them
+};
+
+thread_local SearchStats* thread_search_stats = nullptr; // Search this thread is working on, if any
+thread_local StatsBlock* thread_stats_block = nullptr;
+thread_local StatsBlock idle_stats_block; // Absorbs counts made outside any search
+
+inline StatsBlock& stats_block() {
+    return thread_stats_block ? *thread_stats_block : idle_stats_block;
 }
 
-SolveResult solve_game_ida_star_beam(const GameState& initial_state, int max_paths = MAX_PATHS_TRAVERSED) {
-    auto start_time = std::chrono::high_resolution_clock::now();
-    auto [possible_positions, goal_states] = initial_state.calculate_possible_positions_and_goal_states();
+class StatsScope { // Counts this thread's work towards a search until the scope ends; a null search changes nothing
+public:
+    explicit StatsScope(SearchStats* stats) : previous_stats(thread_search_stats), previous_block(thread_stats_block) {
+        if (stats) {
+            thread_search_stats = stats;
+            thread_stats_block = &stats->add_block();
+        }
+    }
 
-    struct Node {
-        GameState state;
-        int g_cost;
-        int f_cost;
-        double tie_breaker;
-        std::vector<std::pair<int, std::string>> path;
+    ~StatsScope() {
+        thread_search_stats = previous_stats;
+        thread_stats_block = previous_block;
+    }
 
-        Node(GameState s, int g, int f, double tb, std::vector<std::pair<int, std::string>> p)
-            : state(s), g_cost(g), f_cost(f), tie_breaker(tb), path(std::move(p)) {}
-    };
+    StatsScope(const StatsScope&) = delete;
+    StatsScope& operator=(const StatsScope&) = delete;
 
-    int depth_limit = INITIAL_DEPTH_LIMIT;
-    int paths_traversed = 0;
+private:
+    SearchStats* previous_stats;
+    StatsBlock* previous_block;
+};
 
-    while (paths_traversed < max_paths) {
-        std::vector<Node> beam = {Node(initial_state, 0, combined_heuristic(initial_state, goal_states[0]), 0.0, {})};
-        std::unordered_map<std::vector<Position>, int, VectorPositionHash> visited;
+class SampledTimer { // Counts a call and times one call in STATS_TIMING_SAMPLE
+public:
+    SampledTimer(std::atomic<long long>& calls, std::atomic<long long>& sampled_ns) : sampled_ns(sampled_ns) {
+        long long call = calls.load(std::memory_order_relaxed);
+        calls.store(call + 1, std::memory_order_relaxed);
+        timed = call % STATS_TIMING_SAMPLE == 0;
+        if (timed) {
+            started_at = std::chrono::steady_clock::now();
+        }
+    }
 
-        while (!beam.empty() && paths_traversed < max_paths) {
-            std::vector<Node> next_beam;
+    ~SampledTimer() {
+        if (timed) {
+            add_count(sampled_ns, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started_at).count());
+        }
+    }
 
-            for (const auto& current : beam) {
-                paths_traversed++;
+private:
+    std::atomic<long long>& sampled_ns;
+    bool timed;
+    std::chrono::steady_clock::time_point started_at;
+};
 
-                if (paths_traversed % 100000 == 0) {
-                    std::cout << "Level " << initial_state.level << ": Paths traversed: " << paths_traversed 
-                              << " (Using IDA* with Beam Search), Depth: " << current.g_cost << std::endl;
-                }
+inline void note_expansion(int depth) {
+    StatsBlock& block = stats_block();
+    add_count(block.expanded);
+    add_count(block.depth_expanded[std::min(depth, STATS_MAX_DEPTH - 1)]);
+}
 
-                if (std::find(goal_states.begin(), goal_states.end(), current.state) != goal_states.end()) {
-                    std::cout << "Solution found: ";
-                    for (const auto& move : current.path) {
-                        std::cout << "(" << move.first << ", " << move.second << ") ";
-                    }
-                    std::cout << std::endl;
-                    auto end_time = std::chrono::high_resolution_clock::now();
-                    std::chrono::duration<double> total_time = end_time - start_time;
-                    return {paths_traversed, current.path};
-                }
+inline void note_duplicate() {
+    add_count(stats_block().duplicates);
+}
 
-                if (current.g_cost >= depth_limit) continue;
+inline void note_dead_state() {
+    add_count(stats_block().dead_states);
+}
 
-                for (int word_index = 0; word_index < current.state.word_positions.size(); ++word_index) {
-                    for (const auto& [direction_name, direction] : DIRECTIONS) {
-                        GameState new_state = current.state;
-                        new_state.move_word(word_index, direction);
+inline void note_open_size(size_t size) {
+    StatsBlock& block = stats_block();
+    block.open_size.store(static_cast<long long>(size), std::memory_order_relaxed);
+    raise_to(block.open_peak, static_cast<long long>(size));
+}
 
-                        if (visited.find(new_state.word_positions) != visited.end() && 
-                            visited[new_state.word_positions] <= current.g_cost + 1) {
-                            continue;
-                        }
+inline void note_probes(size_t probes) { // Slots a hash table lookup or insert examined
+    add_count(stats_block().probe_lengths[std::min<int>(std::bit_width(probes) - 1, STATS_PROBE_BUCKETS - 1)]);
+}
 
-                        int new_g_cost = current.g_cost + 1;
-                        int new_f_cost = new_g_cost + combined_heuristic(new_state, goal_states[0]);
+const size_t TABLE_NOTE_INTERVAL = 1024; // Insertions between samples of a live hash table's size
 
-                        auto new_path = current.path;
-                        new_path.emplace_back(word_index, direction_name);
+inline void note_table(size_t entries, size_t slots) { // A search's hash table, every TABLE_NOTE_INTERVAL inserts and when freed
+    StatsBlock& block = stats_block();
+    if (static_cast<long long>(entries) > block.table_entries.load(std::memory_order_relaxed)) {
+        block.table_entries.store(static_cast<long long>(entries), std::memory_order_relaxed);
+        block.table_slots.store(static_cast<long long>(slots), std::memory_order_relaxed);
+    }
+}
 
-                        double new_tie_breaker = 0.0;
-                        for (size_t i = 0; i < new_state.word_positions.size(); ++i) {
-                            new_tie_breaker += std::abs(new_state.word_positions[i].first - goal_states[0].word_positions[i].first) +
-                                               std::abs(new_state.word_positions[i].second - goal_states[0].word_positions[i].second);
-                        }
-                        new_tie_breaker /= 1000.0;
+// Background thread that prints one line per open search every interval: the search's totals so far as JSON,
+// plus its expansion rate since the previous line. The searches themselves never print progress.
+class StatsReporter {
+public:
+    explicit StatsReporter(double interval_seconds)
+        : interval(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(interval_seconds))),
+          thread([this]() { run(); }) {}
 
-                        next_beam.emplace_back(new_state, new_g_cost, new_f_cost, new_tie_breaker, std::move(new_path));
-                        visited[new_state.word_positions] = new_g_cost;
-                    }
+    ~StatsReporter() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        thread.join();
+    }
+
+private:
+    void run() {
+        std::map<const SearchStats*, std::pair<std::chrono::steady_clock::time_point, long long>> previous; // Last sample per search
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!wake.wait_for(lock, interval, [this]() { return stopping; })) {
+            auto now = std::chrono::steady_clock::now();
+            std::vector<std::string> lines;
+            std::map<const SearchStats*, std::pair<std::chrono::steady_clock::time_point, long long>> current;
+            {
+                std::lock_guard<std::mutex> open_lock(open_search_stats_mutex);
+                for (const SearchStats* stats : open_search_stats) {
+                    SearchStatsSnapshot snapshot = stats->snapshot();
+                    auto found = previous.find(stats);
+                    auto last = found != previous.end() && found->second.first >= stats->started_at ? found->second
+                                                                                                    : std::make_pair(stats->started_at, 0LL);
+                    double seconds = std::chrono::duration<double>(now - last.first).count();
+                    std::ostringstream line;
+                    line << std::fixed << std::setprecision(1) << "Level " << stats->level << " " << stats->algorithm << " after "
+                         << std::chrono::duration<double>(now - stats->started_at).count() << " s, "
+                         << std::setprecision(0) << (seconds > 0 ? (snapshot.expanded - last.second) / seconds : 0)
+                         << " expanded/s: " << snapshot.to_json(false);
+                    lines.push_back(line.str());
+                    current[stats] = {now, snapshot.expanded};
                 }
             }
+            previous = std::move(current); // Drops finished searches; a reused address is caught by its start time
+            std::lock_guard<std::mutex> cout_lock(cout_mutex);
+            for (const auto& line : lines) {
+                std::cout << line << std::endl;
+            }
+        }
+    }
 
-            std::sort(next_beam.begin(), next_beam.end(), 
-                [](const Node& a, const Node& b) { return a.f_cost < b.f_cost || (a.f_cost == b.f_cost && a.tie_breaker < b.tie_breaker); });
+    std::chrono::steady_clock::duration interval;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::thread thread; // Last, so it starts after the members it uses
+};
 
-            beam = std::vector<Node>(next_beam.begin(), next_beam.begin() + std::min(static_cast<size_t>(BEAM_WIDTH), next_beam.size()));
-        }
+const std::array<std::pair<std::string, Position>, 4> DIRECTIONS = {{ // Possible movement directions
+    {"up", {-1, 0}},
+    {"down", {1, 0}},
+    {"left", {0, -1}},
+    {"right", {0, 1}}
+}};
 
-        depth_limit += 5;
-    }
+using Bitboard = unsigned __int128; // One bit per cell; 8x8 grids only ever touch the low 64-bit word
 
-    return {paths_traversed, {}};
+inline int lowest_cell(Bitboard bits) { // Index of the lowest set bit (bits must be non-zero)
+    uint64_t low = static_cast<uint64_t>(bits);
+    return low ? __builtin_ctzll(low) : 64 + __builtin_ctzll(static_cast<uint64_t>(bits >> 64));
 }
 
-SolveResult solve_game_astar(const GameState& initial_state, int max_paths = MAX_PATHS_TRAVERSED) {
-    auto start_time = std::chrono::high_resolution_clock::now();
-    struct Node {
-        GameState state;
-        int g_cost;
-        int f_cost;
-        double tie_breaker;
-        std::vector<std::pair<int, std::string>> path;
+inline int highest_cell(Bitboard bits) { // Index of the highest set bit (bits must be non-zero)
+    uint64_t high = static_cast<uint64_t>(bits >> 64);
+    return high ? 127 - __builtin_clzll(high) : 63 - __builtin_clzll(static_cast<uint64_t>(bits));
+}
 
-        Node(GameState s, int g, int f, double tb, std::vector<std::pair<int, std::string>> p)
-            : state(s), g_cost(g), f_cost(f), tie_breaker(tb), path(std::move(p)) {}
-    };
+inline uint8_t encode_move(int word_index, int dir) { // One-byte move code: word index * 4 + direction
+    return static_cast<uint8_t>(word_index * NUM_DIRECTIONS + dir);
+}
 
-    struct CompareNode {
-        bool operator()(const Node& lhs, const Node& rhs) const {
-            if (lhs.f_cost == rhs.f_cost) {
-                return lhs.tie_breaker > rhs.tie_breaker;
-            }
-            return lhs.f_cost > rhs.f_cost;
-        }
-    };
+inline Bitboard cell_bit(int cell_index) {
+    return static_cast<Bitboard>(1) << cell_index;
+}
 
-    std::priority_queue<Node, std::vector<Node>, CompareNode> open_list;
-    std::unordered_map<std::vector<Position>, int, VectorPositionHash> closed_list;
+struct PackedState { // Compact search state: one byte cell index per word plus its Zobrist hash
+    std::array<uint8_t, MAX_WORDS> cells;
+    uint64_t hash;
 
-    auto [possible_positions, goal_states] = initial_state.calculate_possible_positions_and_goal_states();
-    
-    double initial_tie_breaker = 0.0;
-    for (size_t i = 0; i < initial_state.word_positions.size(); ++i) {
-        initial_tie_breaker += std::abs(initial_state.word_positions[i].first - goal_states[0].word_positions[i].first) +
-                               std::abs(initial_state.word_positions[i].second - goal_states[0].word_positions[i].second);
+    bool operator==(const PackedState& other) const {
+        return cells == other.cells;
     }
-    initial_tie_breaker /= 1000.0; // Scale down the tie-breaker value
+};
 
-    open_list.emplace(initial_state, 0, combined_heuristic(initial_state, goal_states[0]), initial_tie_breaker, std::vector<std::pair<int, std::string>>());
+struct PackedStateHash {
+    std::size_t operator()(const PackedState& state) const {
+        return state.hash;
+    }
+};
 
-    int paths_traversed = 0;
+class PatternDatabase;
 
-    while (!open_list.empty() && paths_traversed < max_paths) {
-        Node current = open_list.top();
-        open_list.pop();
-        paths_traversed++;
+struct Board { // Immutable level data shared by every node of a search
+    int level;
+    int rows;
+    int cols;
+    int num_words;
+    std::vector<std::string> words;
+    std::vector<Position> walls;
+    std::array<bool, MAX_CELLS> wall_cells{};
+    std::array<std::array<uint8_t, MAX_CELLS>, NUM_DIRECTIONS> stop_cell{}; // Where a slide ends if no word is in the way
+    std::array<std::array<Bitboard, MAX_CELLS>, NUM_DIRECTIONS> slide_ray{}; // Cells passed on the way to stop_cell
+    std::array<int, NUM_DIRECTIONS> cell_step{}; // Cell index delta of one step in each direction
+    std::vector<std::array<uint8_t, MAX_CELLS>> slide_distance; // [target][from] lower bound on slides to bring a word to target
+    int placement_lanes = 0; // Goal placements rounded up to PLACEMENT_LANE_BLOCK
+    std::vector<int16_t> placement_cost; // [word][cell][placement] slides from cell to the word's target; padding lanes are dead
+    std::vector<Bitboard> placement_line; // [placement] cells of the row or column the placement's targets lie on
+    std::vector<uint8_t> placement_horizontal; // [placement] whether that line is a row
+    std::array<std::array<uint64_t, MAX_CELLS>, MAX_WORDS> zobrist{};
+    PackedState initial;
+    std::vector<PackedState> layout_goal_states; // Every goal placement the walls allow, reachable from initial or not
+    std::vector<PackedState> goal_states; // The goal placements analyze_rest_cells leaves reachable from initial
+    std::unordered_set<PackedState, PackedStateHash> goal_set;
+    std::array<Bitboard, MAX_WORDS> reachable_cells{}; // [word] cells the word can ever come to rest in from initial
+    std::array<Bitboard, MAX_WORDS> live_cells{}; // [word] cells from which the word can still reach a target in goal_states
+    bool has_dead_cells = false; // Whether some word can come to rest outside its live cells; if not, no state is dead
+    int possible_positions;
+    std::shared_ptr<const PatternDatabase> pattern_database; // Optional; attached by callers that search with heuristics
+    bool move_pruning = use_move_pruning; // Whether useful_moves drops redundant moves or passes every move through
 
-        if (paths_traversed % 100000 == 0) {
-            std::cout << "Level " << initial_state.level << ": Paths traversed: " << paths_traversed << std::endl;
+    explicit Board(const GameState& state)
+        : level(state.level), rows(state.grid_size.first), cols(state.grid_size.second),
+          num_words(static_cast<int>(state.word_positions.size())), words(state.words), walls(state.walls) {
+        if (num_words > MAX_WORDS || rows < 1 || cols < 1 || rows * cols > MAX_CELLS) {
+            throw std::invalid_argument("Level " + std::to_string(level) + " does not fit in a packed state");
+        }
+        for (const auto& wall : walls) {
+            if (is_out_of_bounds(wall)) {
+                throw std::invalid_argument("Level " + std::to_string(level) + " has a wall off the grid");
+            }
+            wall_cells[cell(wall)] = true;
         }
+        build_slide_tables();
 
-        if (std::find(goal_states.begin(), goal_states.end(), current.state) != goal_states.end()) {
-            std::cout << "Solution found: ";
-            for (const auto& move : current.path) {
-                std::cout << "(" << move.first << ", " << move.second << ") ";
+        std::mt19937_64 rng(0x9e3779b97f4a7c15ULL); // Fixed seed keeps hashes reproducible across runs
+        for (auto& word_keys : zobrist) {
+            for (auto& key : word_keys) {
+                key = rng();
             }
-            std::cout << std::endl;
-            auto end_time = std::chrono::high_resolution_clock::now();
-            std::chrono::duration<double> total_time = end_time - start_time;
-            return {paths_traversed, current.path};
         }
 
-        closed_list[current.state.word_positions] = current.g_cost;
+        initial = pack(state.word_positions);
+        auto [positions, goals] = state.calculate_possible_positions_and_goal_states();
+        possible_positions = positions;
+        for (const auto& goal : goals) {
+            layout_goal_states.push_back(pack(goal.word_positions));
+        }
+        analyze_rest_cells();
+        build_distance_tables();
+        build_placement_costs();
+        build_placement_lines();
+    }
 
-        for (int word_index = 0; word_index < current.state.word_positions.size(); ++word_index) {
-            for (const auto& [direction_name, direction] : DIRECTIONS) {
-                GameState new_state = current.state;
-                new_state.move_word(word_index, direction);
+    int cell(const Position& pos) const {
+        return pos.first * cols + pos.second;
+    }
 
-                if (closed_list.find(new_state.word_positions) != closed_list.end()) {
-                    continue;
-                }
+    Position position(int cell_index) const {
+        return {cell_index / cols, cell_index % cols};
+    }
+
+    PackedState pack(const std::vector<Position>& positions) const {
+        PackedState state;
+        state.cells.fill(NO_CELL);
+        state.hash = 0;
+        for (size_t i = 0; i < positions.size(); ++i) {
+            state.cells[i] = static_cast<uint8_t>(cell(positions[i]));
+            state.hash ^= zobrist[i][state.cells[i]];
+        }
+        return state;
+    }
 
-                int new_g_cost = current.g_cost + 1;
-                int new_f_cost = new_g_cost + combined_heuristic(new_state, goal_states[0]);
+    PackedState pack_cells(const uint8_t* word_cells) const { // Rebuild a state, hash included, from num_words cell bytes
+        PackedState state;
+        state.cells.fill(NO_CELL);
+        state.hash = 0;
+        for (int i = 0; i < num_words; ++i) {
+            state.cells[i] = word_cells[i];
+            state.hash ^= zobrist[i][state.cells[i]];
+        }
+        return state;
+    }
+
+    std::vector<Position> unpack(const PackedState& state) const {
+        std::vector<Position> positions;
+        for (int i = 0; i < num_words; ++i) {
+            positions.push_back(position(state.cells[i]));
+        }
+        return positions;
+    }
 
-                auto new_path = current.path;
-                new_path.emplace_back(word_index, direction_name);
+    bool is_out_of_bounds(const Position& pos) const {
+        return pos.first < 0 || pos.first >= rows || pos.second < 0 || pos.second >= cols;
+    }
 
-                double new_tie_breaker = 0.0;
-                for (size_t i = 0; i < new_state.word_positions.size(); ++i) {
-                    new_tie_breaker += std::abs(new_state.word_positions[i].first - goal_states[0].word_positions[i].first) +
-                                       std::abs(new_state.word_positions[i].second - goal_states[0].word_positions[i].second);
+    void build_slide_tables() { // Precompute the wall-only slide of every cell in every direction
+        for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+            const Position& direction = DIRECTIONS[dir].second;
+            cell_step[dir] = direction.first * cols + direction.second;
+            for (int cell_index = 0; cell_index < rows * cols; ++cell_index) {
+                Position current_position = position(cell_index);
+                Position new_position = {current_position.first + direction.first, current_position.second + direction.second};
+                Bitboard ray = 0;
+                while (!is_out_of_bounds(new_position) && !wall_cells[cell(new_position)]) {
+                    current_position = new_position;
+                    ray |= cell_bit(cell(current_position));
+                    new_position = {current_position.first + direction.first, current_position.second + direction.second};
                 }
-                new_tie_breaker /= 1000.0; // Scale down the tie-breaker value
+                stop_cell[dir][cell_index] = static_cast<uint8_t>(cell(current_position));
+                slide_ray[dir][cell_index] = ray;
+            }
+        }
+    }
 
-                open_list.emplace(new_state, new_g_cost, new_f_cost, new_tie_breaker, std::move(new_path));
+    // Cells a slide from from may end in when a word can only stop against a wall, the edge or a cell in blockers:
+    // the end of each ray, and every cell on it whose next cell is in blockers. Words in the way are ignored.
+    Bitboard rest_stops(int from, Bitboard blockers) const {
+        Bitboard stops = 0;
+        for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+            for (Bitboard ray = slide_ray[dir][from]; ray; ray &= ray - 1) {
+                int cell_index = lowest_cell(ray);
+                if (cell_index == stop_cell[dir][from] || (blockers & cell_bit(cell_index + cell_step[dir]))) {
+                    stops |= cell_bit(cell_index);
+                }
             }
         }
+        return stops;
     }
 
-    return {paths_traversed, {}};
-}
+    // Static analysis of where words can come to rest. A word only stops against a wall, the edge or another word,
+    // so it can only rest in front of a cell some other word can occupy. Each word's reachable cells grow from its
+    // initial cell under that rule until no word's set changes; ignoring the words in the way makes every layout
+    // the level can reach fall inside them. Goal placements with a target outside its word's reachable cells are
+    // dropped, and a word is live in the cells from which it can still slide to a target of a remaining placement,
+    // so a state with a word outside its live cells can never be solved.
+    void analyze_rest_cells() {
+        for (int i = 0; i < num_words; ++i) {
+            reachable_cells[i] = cell_bit(initial.cells[i]);
+        }
+        auto others = [this](int word_index) { // Cells another word may block word_index against
+            Bitboard blockers = 0;
+            for (int j = 0; j < num_words; ++j) {
+                if (j != word_index) {
+                    blockers |= reachable_cells[j];
+                }
+            }
+            return blockers;
+        };
+        for (bool grew = true; grew;) {
+            grew = false;
+            for (int i = 0; i < num_words; ++i) {
+                Bitboard blockers = others(i);
+                for (Bitboard frontier = reachable_cells[i]; frontier;) {
+                    int from = lowest_cell(frontier);
+                    frontier &= frontier - 1;
+                    Bitboard added = rest_stops(from, blockers) & ~reachable_cells[i];
+                    reachable_cells[i] |= added;
+                    frontier |= added;
+                    grew = grew || added;
+                }
+            }
+        }
 
-std::vector<std::unique_ptr<GameState>> load_level_data(const std::string& csv_file) { // Load level data from a CSV file
-    std::vector<std::unique_ptr<GameState>> levels;
-    std::ifstream file(csv_file);
-    std::string line;
-    std::getline(file, line); // Skip the header line
+        for (const auto& goal_state : layout_goal_states) {
+            bool reachable = true;
+            for (int i = 0; i < num_words && reachable; ++i) {
+                reachable = (reachable_cells[i] & cell_bit(goal_state.cells[i])) != 0;
+            }
+            if (reachable) {
+                goal_states.push_back(goal_state);
+                goal_set.insert(goal_state);
+            }
+        }
 
-    while (std::getline(file, line)) {
-        std::istringstream iss(line);
-        std::string level_str, sentence, type, row_str, col_str;
-        std::getline(iss, level_str, ',');
-        std::getline(iss, sentence, ',');
-        std::getline(iss, type, ',');
-        std::getline(iss, row_str, ',');
-        std::getline(iss, col_str, ',');
+        for (int i = 0; i < num_words; ++i) {
+            Bitboard blockers = others(i);
+            Bitboard& live = live_cells[i];
+            for (const auto& goal_state : goal_states) {
+                live |= cell_bit(goal_state.cells[i]);
+            }
+            for (bool grew = true; grew;) { // Add every cell with a stop in the live set until none is left
+                grew = false;
+                for (int from = 0; from < rows * cols; ++from) {
+                    if (!wall_cells[from] && !(live & cell_bit(from)) && (rest_stops(from, blockers) & live)) {
+                        live |= cell_bit(from);
+                        grew = true;
+                    }
+                }
+            }
+            has_dead_cells = has_dead_cells || (reachable_cells[i] & ~live);
+        }
+    }
 
-        int level = std::stoi(level_str);
-        int row = std::stoi(row_str);
-        int col = std::stoi(col_str);
+    // Slides needed to bring a lone word from each cell to each target, using walls only. Any cell along a
+    // ray counts as a stop, since another word may be the blocker, which keeps the distance a lower bound.
+    void build_distance_tables() {
+        slide_distance.assign(rows * cols, {});
+        for (int target = 0; target < rows * cols; ++target) {
+            auto& distance = slide_distance[target];
+            distance.fill(UNREACHABLE);
+            if (wall_cells[target]) {
+                continue;
+            }
+            // Straight wall-free lines are symmetric, so a forward BFS from the target gives distances to it
+            std::vector<int> frontier = {target};
+            distance[target] = 0;
+            for (int depth = 1; !frontier.empty(); ++depth) {
+                std::vector<int> next_frontier;
+                for (int from : frontier) {
+                    Bitboard reachable = 0;
+                    for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                        reachable |= slide_ray[dir][from];
+                    }
+                    while (reachable) {
+                        int next = lowest_cell(reachable);
+                        reachable &= reachable - 1;
+                        if (distance[next] == UNREACHABLE) {
+                            distance[next] = static_cast<uint8_t>(depth);
+                            next_frontier.push_back(next);
+                        }
+                    }
+                }
+                frontier.swap(next_frontier);
+            }
+        }
+    }
 
-        if (levels.size() < level) { // Ensure the levels vector is large enough
-            levels.emplace_back(std::make_unique<GameState>(level, std::move(sentence), std::vector<Position>(), std::vector<Position>(), Position{8, 8}));
+    // slide_distance regrouped so each word and cell has one contiguous row over the goal placements, with
+    // unreachable targets at DEAD_STATE_COST. Sums over num_words rows stay within int16.
+    void build_placement_costs() {
+        placement_lanes = (static_cast<int>(goal_states.size()) + PLACEMENT_LANE_BLOCK - 1) / PLACEMENT_LANE_BLOCK * PLACEMENT_LANE_BLOCK;
+        placement_cost.assign(static_cast<size_t>(num_words) * rows * cols * placement_lanes, DEAD_STATE_COST);
+        for (int word_index = 0; word_index < num_words; ++word_index) {
+            for (int cell_index = 0; cell_index < rows * cols; ++cell_index) {
+                int16_t* row = &placement_cost[placement_row(word_index, cell_index)];
+                for (size_t placement = 0; placement < goal_states.size(); ++placement) {
+                    uint8_t distance = slide_distance[goal_states[placement].cells[word_index]][cell_index];
+                    row[placement] = distance == UNREACHABLE ? DEAD_STATE_COST : distance;
+                }
+            }
         }
+    }
 
-        if (type.find("Word") != std::string::npos) { // Add word positions
-            levels[level - 1]->word_positions.emplace_back(row, col);
-        } else if (type.find("Wall") != std::string::npos) { // Add wall positions
-            levels[level - 1]->walls.emplace_back(row, col);
+    void build_placement_lines() { // The full row or column through each goal placement
+        for (const auto& goal_state : goal_states) {
+            bool horizontal = num_words < 2 || goal_state.cells[0] / cols == goal_state.cells[1] / cols;
+            Bitboard line = 0;
+            for (int cell_index = 0; cell_index < rows * cols; ++cell_index) {
+                if (horizontal ? cell_index / cols == goal_state.cells[0] / cols : cell_index % cols == goal_state.cells[0] % cols) {
+                    line |= cell_bit(cell_index);
+                }
+            }
+            placement_line.push_back(line);
+            placement_horizontal.push_back(horizontal);
         }
     }
 
-    return levels;
-}
+    size_t placement_row(int word_index, int cell_index) const { // Offset of a word's placement cost row for a cell
+        return (static_cast<size_t>(word_index) * rows * cols + cell_index) * placement_lanes;
+    }
 
+    // Members templated on Words take the word count as a compile-time constant when it is non-zero, so the
+    // per-word loops of the specialised solvers unroll; Words = 0 reads num_words at run time.
+    template <int Words = 0>
+    int word_count() const {
+        return Words ? Words : num_words;
+    }
 
-SolveResult solve_game_bfs(const GameState& initial_state, int max_depth = MAX_PATH_LENGTH, int max_paths = MAX_PATHS_TRAVERSED) {
-    std::queue<GameState> search_queue;
-    std::unordered_map<std::vector<Position>, std::vector<std::pair<int, std::string>>, VectorPositionHash> visited;
+    template <int Words = 0>
+    Bitboard occupancy(const PackedState& state) const { // Bitboard of the cells holding words
+        Bitboard bits = 0;
+        for (int i = 0; i < word_count<Words>(); ++i) {
+            bits |= cell_bit(state.cells[i]);
+        }
+        return bits;
+    }
 
-    search_queue.push(initial_state);
-    visited[initial_state.word_positions] = {};
+    bool is_occupied(const PackedState& state, const Position& pos) const { // Check if a cell holds a word or wall
+        int cell_index = cell(pos);
+        return wall_cells[cell_index] || (occupancy(state) & cell_bit(cell_index)) != 0;
+    }
 
-    auto [possible_positions, goal_states] = initial_state.calculate_possible_positions_and_goal_states();
+    uint8_t slide(int from, int dir, Bitboard words_bits) const { // Cell a word starting at from comes to rest in
+        Bitboard blockers = slide_ray[dir][from] & words_bits;
+        if (!blockers) {
+            return stop_cell[dir][from];
+        }
+        int nearest = (dir == 0 || dir == 2) ? highest_cell(blockers) : lowest_cell(blockers); // Up/left scan towards lower indices
+        return static_cast<uint8_t>(nearest - cell_step[dir]);
+    }
 
-    int paths_traversed = 0;
-    auto start_time = std::chrono::steady_clock::now();
-    auto last_checkpoint_time = start_time;
+    bool is_goal(const PackedState& state) const {
+        return goal_set.count(state) != 0;
+    }
 
-    while (!search_queue.empty() && paths_traversed < max_paths) {
-        paths_traversed++;
-        if (paths_traversed % 100000 == 0) {
-            auto current_time = std::chrono::steady_clock::now();
-            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(current_time - last_checkpoint_time);
-            double speed = 100000.0 / (duration.count() / 1000.0);
-            std::cout << "Level " << initial_state.level << ": Paths traversed: " << paths_traversed 
-                      << " (Using BFS), BFS depth: " << visited[search_queue.front().word_positions].size()
-                      << ", Speed: " << std::fixed << std::setprecision(2) << speed << " paths/sec" << std::endl;
-            last_checkpoint_time = current_time;
-        }
-
-        GameState current_state = search_queue.front();
-        search_queue.pop();
-
-        if (std::find(goal_states.begin(), goal_states.end(), current_state) != goal_states.end()) {
-            auto path = visited[current_state.word_positions];
-            std::cout << "Solution found: ";
-            for (const auto& move : path) {
-                std::cout << "(" << move.first << ", " << move.second << ") ";
-            }
-            std::cout << std::endl;
-            return {paths_traversed, path};
+    template <int Words = 0>
+    bool is_dead(const PackedState& state) const { // Whether a word sits where it can no longer reach any target
+        if (!has_dead_cells) {
+            return false;
+        }
+        for (int i = 0; i < word_count<Words>(); ++i) {
+            if (!(live_cells[i] & cell_bit(state.cells[i]))) {
+                return true;
+            }
         }
+        return false;
+    }
 
-        if (visited[current_state.word_positions].size() >= max_depth) {
-            continue;
+    void move_word(PackedState& state, int word_index, int dir) const { // Slide a word until blocked, updating the hash
+        uint8_t new_cell = slide(state.cells[word_index], dir, occupancy(state));
+        state.hash ^= zobrist[word_index][state.cells[word_index]] ^ zobrist[word_index][new_cell];
+        state.cells[word_index] = new_cell;
+    }
+
+    // Generate all num_words * 4 successors of a state, word-major in DIRECTIONS order; returns the count
+    template <int Words = 0>
+    int generate_successors(const PackedState& state, std::array<PackedState, MAX_WORDS * NUM_DIRECTIONS>& successors) const {
+        StatsBlock& stats = stats_block();
+        SampledTimer timer(stats.move_generation_calls, stats.move_generation_sampled_ns);
+        Bitboard words_bits = occupancy<Words>(state);
+        int count = 0;
+        for (int word_index = 0; word_index < word_count<Words>(); ++word_index) {
+            uint8_t from = state.cells[word_index];
+            for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                uint8_t to = slide(from, dir, words_bits);
+                PackedState& successor = successors[count++];
+                successor = state;
+                successor.cells[word_index] = to;
+                successor.hash ^= zobrist[word_index][from] ^ zobrist[word_index][to];
+            }
+        }
+        add_count(stats.generated, count);
+        return count;
+    }
+
+    // Cells a slide from -> to depends on: its start, the cells it crossed and the word it stopped against, if any
+    Bitboard move_footprint(int from, int dir, int to) const {
+        Bitboard footprint = cell_bit(from) | (slide_ray[dir][from] & ~slide_ray[dir][to]);
+        Bitboard beyond = slide_ray[dir][to];
+        if (beyond) { // Not stopped by a wall or the edge, so the nearest cell beyond held a word
+            footprint |= cell_bit((dir == 0 || dir == 2) ? highest_cell(beyond) : lowest_cell(beyond));
         }
+        return footprint;
+    }
 
-        for (int word_index = 0; word_index < current_state.word_positions.size(); ++word_index) {
-            for (const auto& [direction_name, direction] : DIRECTIONS) {
-                GameState new_state = current_state;
-                new_state.move_word(word_index, direction);
-                if (!visited.count(new_state.word_positions)) {
-                    auto new_path = visited[current_state.word_positions];
-                    new_path.emplace_back(word_index, direction_name);
-                    visited[new_state.word_positions] = new_path;
-                    search_queue.push(new_state);
+    // Mask of the move codes worth expanding among generate_successors' output, for a state entered by last_move
+    // from cell last_from (NO_MOVE at the root). Drops moves that leave their word in place and moves that slide
+    // the last word straight back to last_from. Two moves commute when neither touches the other's footprint;
+    // of the two orders only the one moving the lower word index first is kept.
+    template <int Words = 0>
+    uint64_t useful_moves(const PackedState& state, const std::array<PackedState, MAX_WORDS * NUM_DIRECTIONS>& successors,
+                          uint8_t last_move, uint8_t last_from) const {
+        int move_count = word_count<Words>() * NUM_DIRECTIONS;
+        uint64_t all_moves = move_count == 64 ? ~uint64_t(0) : (uint64_t(1) << move_count) - 1;
+        if (!move_pruning) {
+            return all_moves;
+        }
+        int last_word = -1;
+        int last_dir = 0;
+        Bitboard last_footprint = 0;
+        Bitboard last_cells = 0;
+        if (last_move != NO_MOVE) {
+            last_word = last_move / NUM_DIRECTIONS;
+            last_dir = last_move % NUM_DIRECTIONS;
+            last_footprint = move_footprint(last_from, last_dir, state.cells[last_word]);
+            last_cells = cell_bit(last_from) | cell_bit(state.cells[last_word]);
+        }
+        uint64_t moves = 0;
+        int null_moves = 0;
+        for (int move = 0; move < move_count; ++move) {
+            int word_index = move / NUM_DIRECTIONS;
+            int dir = move % NUM_DIRECTIONS;
+            uint8_t from = state.cells[word_index];
+            uint8_t to = successors[move].cells[word_index];
+            if (to == from) {
+                null_moves++;
+                continue; // Already against a blocker
+            }
+            if (word_index == last_word) {
+                if (dir == (last_dir ^ 1) && to == last_from) {
+                    continue; // Undoes the last move
                 }
+            } else if (word_index < last_word && !(last_footprint & (cell_bit(from) | cell_bit(to))) &&
+                       !(move_footprint(from, dir, to) & last_cells)) {
+                continue; // Commutes with the last move; the other order reaches the same state
             }
+            moves |= uint64_t(1) << move;
         }
+        StatsBlock& stats = stats_block();
+        add_count(stats.null_moves, null_moves);
+        add_count(stats.pruned_moves, move_count - null_moves - std::popcount(moves));
+        return moves;
+    }
+
+    // Append every state that reaches this one in a single slide, paired with that slide's move code. A word at
+    // x moved in direction d if it cannot slide further that way, and it may have started at any free cell
+    // along the ray behind x.
+    void generate_predecessors(const PackedState& state, std::vector<std::pair<PackedState, uint8_t>>& predecessors) const {
+        Bitboard words_bits = occupancy(state);
+        size_t first_new = predecessors.size();
+        for (int word_index = 0; word_index < num_words; ++word_index) {
+            uint8_t to = state.cells[word_index];
+            for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                if (slide(to, dir, words_bits) != to) {
+                    continue;
+                }
+                int back = dir ^ 1; // up <-> down, left <-> right
+                Bitboard behind = slide_ray[back][to];
+                for (int from = to - cell_step[dir]; from >= 0 && from < rows * cols && (behind & cell_bit(from)) && !(words_bits & cell_bit(from));
+                     from -= cell_step[dir]) {
+                    PackedState predecessor = state;
+                    predecessor.cells[word_index] = static_cast<uint8_t>(from);
+                    predecessor.hash ^= zobrist[word_index][to] ^ zobrist[word_index][from];
+                    predecessors.emplace_back(predecessor, encode_move(word_index, dir));
+                }
+            }
+        }
+        add_count(stats_block().generated, static_cast<long long>(predecessors.size() - first_new));
+    }
+};
+
+const size_t PDB_MAX_ENTRIES = 1 << 24; // Largest single pattern table in bytes (four words on 8x8, three on 10x10)
+const char* const PDB_DIRECTORY = "pdb"; // Where pattern databases are persisted, relative to the working directory
+
+// Additive pattern databases over consecutive groups of words. Each group's table is built by a BFS from every
+// goal placement in an abstraction that keeps only the group's words; the removed words become potential
+// blockers, so a tracked word may stop anywhere along its ray. Every real move maps to a move in exactly one
+// abstraction, so the per-group distances add up to a lower bound. Tables are written to PDB_DIRECTORY once
+// per layout and memory-mapped on later runs.
+class PatternDatabase {
+public:
+    static std::shared_ptr<const PatternDatabase> load_or_build(const Board& board) {
+        auto database = std::shared_ptr<PatternDatabase>(new PatternDatabase(board));
+        std::string path = std::string(PDB_DIRECTORY) + "/" + hex(database->layout_hash) + ".pdb";
+        if (!database->map_file(path)) {
+            database->build(board);
+            database->write_file(path);
+        }
+        return database;
+    }
+
+    ~PatternDatabase() {
+        if (mapping) {
+            munmap(mapping, mapping_size);
+        }
+    }
+
+    int lookup(const PackedState& state) const { // Summed group distances, or DEAD_STATE_COST if a group cannot finish
+        int total = 0;
+        for (size_t group = 0; group < groups.size(); ++group) {
+            size_t index = 0;
+            for (int word_index : groups[group]) {
+                index = index * cell_count + state.cells[word_index];
+            }
+            uint8_t distance = tables[group][index];
+            if (distance == UNREACHABLE) {
+                return DEAD_STATE_COST;
+            }
+            total += distance;
+        }
+        return total;
+    }
+
+private:
+    struct FileHeader {
+        char magic[8];
+        uint64_t layout_hash;
+        uint32_t rows;
+        uint32_t cols;
+        uint32_t num_words;
+        uint32_t group_size;
+    };
+
+    explicit PatternDatabase(const Board& board) : cell_count(board.rows * board.cols) {
+        group_size = 1;
+        size_t entries = cell_count;
+        while (group_size < board.num_words && entries * cell_count <= PDB_MAX_ENTRIES) {
+            entries *= cell_count;
+            group_size++;
+        }
+        for (int first = 0; first < board.num_words; first += group_size) {
+            std::vector<int> group;
+            for (int word_index = first; word_index < std::min(first + group_size, board.num_words); ++word_index) {
+                group.push_back(word_index);
+            }
+            groups.push_back(std::move(group));
+        }
+
+        // Tables depend only on grid size, walls, word count and grouping, not on where the words start
+        layout_hash = 14695981039346656037ULL; // FNV-1a
+        auto mix = [this](uint64_t value) {
+            layout_hash = (layout_hash ^ value) * 1099511628211ULL;
+        };
+        mix(board.rows);
+        mix(board.cols);
+        mix(board.num_words);
+        mix(group_size);
+        for (int cell_index = 0; cell_index < cell_count; ++cell_index) {
+            if (board.wall_cells[cell_index]) {
+                mix(cell_index);
+            }
+        }
+        header = {{'W', 'C', 'P', 'D', 'B', '1', 0, 0}, layout_hash, static_cast<uint32_t>(board.rows),
+                  static_cast<uint32_t>(board.cols), static_cast<uint32_t>(board.num_words), static_cast<uint32_t>(group_size)};
+    }
+
+    static std::string hex(uint64_t value) {
+        std::ostringstream oss;
+        oss << std::hex << std::setw(16) << std::setfill('0') << value;
+        return oss.str();
+    }
+
+    size_t table_size(size_t group) const {
+        size_t entries = 1;
+        for (size_t i = 0; i < groups[group].size(); ++i) {
+            entries *= cell_count;
+        }
+        return entries;
+    }
+
+    size_t file_size() const {
+        size_t size = sizeof(FileHeader);
+        for (size_t group = 0; group < groups.size(); ++group) {
+            size += table_size(group);
+        }
+        return size;
+    }
+
+    bool map_file(const std::string& path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info;
+        bool valid = fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) == file_size();
+        void* data = valid ? mmap(nullptr, file_size(), PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+        close(fd);
+        if (data == MAP_FAILED) {
+            return false;
+        }
+        if (std::memcmp(data, &header, sizeof(FileHeader)) != 0) {
+            munmap(data, file_size());
+            return false;
+        }
+        mapping = data;
+        mapping_size = file_size();
+        const uint8_t* table = static_cast<const uint8_t*>(data) + sizeof(FileHeader);
+        for (size_t group = 0; group < groups.size(); ++group) {
+            tables.push_back(table);
+            table += table_size(group);
+        }
+        return true;
+    }
+
+    void write_file(const std::string& path) const { // Best effort: a failed write only costs a rebuild next time
+        std::error_code error;
+        std::filesystem::create_directories(PDB_DIRECTORY, error);
+        std::string temp_path = path + "." + std::to_string(getpid()) + ".tmp";
+        {
+            std::ofstream file(temp_path, std::ios::binary);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+            for (const auto& table : owned_tables) {
+                file.write(reinterpret_cast<const char*>(table.data()), table.size());
+            }
+            if (!file) {
+                std::filesystem::remove(temp_path, error);
+                return;
+            }
+        }
+        std::filesystem::rename(temp_path, path, error);
+    }
+
+    void build(const Board& board) {
+        for (size_t group = 0; group < groups.size(); ++group) {
+            owned_tables.push_back(build_table(board, group));
+            tables.push_back(owned_tables.back().data());
+        }
+    }
+
+    std::vector<uint8_t> build_table(const Board& board, size_t group_index) const {
+        const std::vector<int>& group = groups[group_index];
+        int k = static_cast<int>(group.size());
+        std::vector<uint8_t> table(table_size(group_index), UNREACHABLE);
+        std::vector<size_t> stride(k, 1);
+        for (int j = k - 2; j >= 0; --j) {
+            stride[j] = stride[j + 1] * cell_count;
+        }
+
+        std::vector<uint32_t> frontier;
+        for (const auto& goal : board.layout_goal_states) { // Tables are shared by every starting layout
+            size_t index = 0;
+            for (int word_index : group) {
+                index = index * cell_count + goal.cells[word_index];
+            }
+            if (table[index] == UNREACHABLE) {
+                table[index] = 0;
+                frontier.push_back(static_cast<uint32_t>(index));
+            }
+        }
+
+        // Moves in the abstraction are symmetric (a tracked word may stop anywhere along a clear ray), so a
+        // forward BFS from the goals gives distances to the goals
+        std::array<int, MAX_WORDS> cells{};
+        for (int depth = 1; !frontier.empty(); ++depth) {
+            std::vector<uint32_t> next_frontier;
+            for (uint32_t index : frontier) {
+                Bitboard occupied = 0;
+                for (int j = 0; j < k; ++j) {
+                    cells[j] = static_cast<int>((index / stride[j]) % cell_count);
+                    occupied |= cell_bit(cells[j]);
+                }
+                for (int j = 0; j < k; ++j) {
+                    for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                        Bitboard ray = board.slide_ray[dir][cells[j]];
+                        int step = board.cell_step[dir];
+                        for (int next = cells[j] + step; next >= 0 && next < cell_count && (ray & cell_bit(next)) && !(occupied & cell_bit(next));
+                             next += step) {
+                            size_t next_index = index + (next - cells[j]) * static_cast<long>(stride[j]);
+                            if (table[next_index] == UNREACHABLE) {
+                                table[next_index] = static_cast<uint8_t>(depth);
+                                next_frontier.push_back(static_cast<uint32_t>(next_index));
+                            }
+                        }
+                    }
+                }
+            }
+            frontier.swap(next_frontier);
+        }
+        return table;
+    }
+
+    int cell_count;
+    int group_size;
+    std::vector<std::vector<int>> groups;
+    uint64_t layout_hash;
+    FileHeader header;
+    std::vector<const uint8_t*> tables;
+    std::vector<std::vector<uint8_t>> owned_tables;
+    void* mapping = nullptr;
+    size_t mapping_size = 0;
+};
+
+using MovePath = std::vector<std::pair<int, std::string>>; // (word index, direction name) per move
+
+void print_solution(const MovePath& path) { // One locked line, so solvers racing on a level do not interleave
+    std::ostringstream line;
+    line << "Solution found: ";
+    for (const auto& move : path) {
+        line << "(" << move.first << ", " << move.second << ") ";
+    }
+    std::lock_guard<std::mutex> lock(cout_mutex);
+    std::cout << line.str() << std::endl;
+}
+
+struct SolveResult {
+    int paths_traversed;
+    MovePath solution;
+    bool proven_optimal = false; // Set by solvers whose optimality depends on the run, such as ARA* finishing its last pass
+    SearchStatsSnapshot stats{}; // Filled in by run_solver
+};
+
+const int STOP_POLL_INTERVAL = 1024; // Expansions between checks of a StopToken
+
+// Cancellation flag plus an optional deadline, shared between a search and whoever started it. Searches poll it
+// every STOP_POLL_INTERVAL expansions and return what they have, usually no solution, once it fires. A token
+// made from a parent also fires when the parent does. It also carries the shortest solution length found by
+// any search sharing it; searches prune nodes whose f-cost reaches that incumbent.
+class StopToken {
+public:
+    StopToken() = default;
+
+    explicit StopToken(const StopToken* parent) : parent(parent) {}
+
+    void cancel() {
+        cancelled.store(true, std::memory_order_relaxed);
+    }
+
+    void set_deadline(std::chrono::steady_clock::time_point time) {
+        deadline = time;
+        has_deadline = true;
+    }
+
+    bool is_cancelled() const {
+        return cancelled.load(std::memory_order_relaxed) || (parent && parent->is_cancelled());
+    }
+
+    bool deadline_passed() const {
+        return (has_deadline && std::chrono::steady_clock::now() >= deadline) || (parent && parent->deadline_passed());
+    }
+
+    bool stop_requested() const {
+        return is_cancelled() || deadline_passed();
+    }
+
+    int incumbent() const {
+        return incumbent_length.load(std::memory_order_relaxed);
+    }
+
+    bool offer_incumbent(int length) const { // Lower the incumbent to length; false if it was already as short
+        int current = incumbent_length.load(std::memory_order_relaxed);
+        while (length < current) {
+            if (incumbent_length.compare_exchange_weak(current, length, std::memory_order_relaxed)) {
+                std::chrono::steady_clock::rep unset = 0;
+                first_incumbent_ticks.compare_exchange_strong(unset, std::chrono::steady_clock::now().time_since_epoch().count(),
+                                                              std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::chrono::steady_clock::time_point first_incumbent_time() const { // When a solution was first offered; the epoch if never
+        return std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(first_incumbent_ticks.load(std::memory_order_relaxed)));
+    }
+
+private:
+    const StopToken* parent = nullptr;
+    std::atomic<bool> cancelled{false};
+    mutable std::atomic<int> incumbent_length{std::numeric_limits<int>::max()}; // Shared by searches holding const tokens
+    mutable std::atomic<std::chrono::steady_clock::rep> first_incumbent_ticks{0};
+    bool has_deadline = false;
+    std::chrono::steady_clock::time_point deadline;
+};
+
+inline bool should_stop(const StopToken* stop, long long paths_traversed) { // Cheap per-expansion poll of an optional token
+    return stop && paths_traversed % STOP_POLL_INTERVAL == 0 && stop->stop_requested();
+}
+
+inline int incumbent_bound(const StopToken* stop) { // Solution length a node's f-cost must stay below to be worth searching
+    return stop ? stop->incumbent() : std::numeric_limits<int>::max();
+}
+
+const uint32_t NO_NODE = 0xFFFFFFFF; // Parent of the root node / empty table slot
+
+struct ArenaNode { // Search node; the path is implied by following parent links back to the root
+    PackedState state;
+    uint32_t parent;
+    uint8_t move;
+    bool merged; // Also reached at this depth through another parent, so no move pruning applies
+    uint16_t depth;
+};
+
+class NodeArena { // Append-only node pool in fixed-size chunks so indices stay valid and nodes are never copied
+public:
+    uint32_t add(const PackedState& state, uint32_t parent, uint8_t move, int depth) {
+        if ((count & CHUNK_MASK) == 0 && (count >> CHUNK_BITS) == chunks.size()) {
+            chunks.emplace_back(new ArenaNode[CHUNK_SIZE]);
+        }
+        chunks[count >> CHUNK_BITS][count & CHUNK_MASK] = {state, parent, move, false, static_cast<uint16_t>(depth)};
+        return count++;
+    }
+
+    void mark_merged(uint32_t index) {
+        chunks[index >> CHUNK_BITS][index & CHUNK_MASK].merged = true;
+    }
+
+    void reparent(uint32_t index, uint32_t parent, uint8_t move, int depth) { // Point a node at a shorter path
+        ArenaNode& node = chunks[index >> CHUNK_BITS][index & CHUNK_MASK];
+        node.parent = parent;
+        node.move = move;
+        node.depth = static_cast<uint16_t>(depth);
+    }
+
+    // Last move and its starting cell to prune successors against; NO_MOVE for the root and merged nodes
+    std::pair<uint8_t, uint8_t> last_move(uint32_t index) const {
+        const ArenaNode& node = (*this)[index];
+        if (node.parent == NO_NODE || node.merged) {
+            return {NO_MOVE, NO_CELL};
+        }
+        return {node.move, (*this)[node.parent].state.cells[node.move / NUM_DIRECTIONS]};
+    }
+
+    const ArenaNode& operator[](uint32_t index) const {
+        return chunks[index >> CHUNK_BITS][index & CHUNK_MASK];
+    }
+
+    uint32_t size() const {
+        return count;
+    }
+
+    void clear() { // Keep the allocated chunks for reuse
+        count = 0;
+    }
+
+    MovePath path_to(uint32_t index) const { // Rebuild the move list from the root to a node
+        MovePath path;
+        for (uint32_t current = index; (*this)[current].parent != NO_NODE; current = (*this)[current].parent) {
+            uint8_t move = (*this)[current].move;
+            path.emplace_back(move / NUM_DIRECTIONS, DIRECTIONS[move % NUM_DIRECTIONS].first);
+        }
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+private:
+    static const uint32_t CHUNK_BITS = 16;
+    static const uint32_t CHUNK_SIZE = 1u << CHUNK_BITS;
+    static const uint32_t CHUNK_MASK = CHUNK_SIZE - 1;
+
+    std::vector<std::unique_ptr<ArenaNode[]>> chunks;
+    uint32_t count = 0;
+};
+
+class NodeTable { // Open-addressing map from packed state to the arena node holding it
+public:
+    explicit NodeTable(const NodeArena& node_arena) : arena(node_arena), slots(1024, NO_NODE), mask(1023) {}
+
+    ~NodeTable() {
+        note_table(count, slots.size());
+    }
+
+    uint32_t find(const PackedState& state) const { // Node index for a state, or NO_NODE
+        for (size_t slot = state.hash & mask, probes = 1;; slot = (slot + 1) & mask, ++probes) {
+            if (slots[slot] == NO_NODE || arena[slots[slot]].state == state) {
+                note_probes(probes);
+                return slots[slot];
+            }
+        }
+    }
+
+    bool insert(uint32_t node_index) { // Insert a node's state; false if the state is already present
+        return place(node_index, false);
+    }
+
+    void assign(uint32_t node_index) { // Insert a node's state, replacing any existing entry for it
+        place(node_index, true);
+    }
+
+    void clear() {
+        std::fill(slots.begin(), slots.end(), NO_NODE);
+        count = 0;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+private:
+    bool place(uint32_t node_index, bool replace) {
+        if ((count + 1) * 2 > slots.size()) { // Keep the load factor at or below one half
+            grow();
+        }
+        const PackedState& state = arena[node_index].state;
+        for (size_t slot = state.hash & mask, probes = 1;; slot = (slot + 1) & mask, ++probes) {
+            if (slots[slot] == NO_NODE) {
+                slots[slot] = node_index;
+                if (++count % TABLE_NOTE_INTERVAL == 0) {
+                    note_table(count, slots.size());
+                }
+                note_probes(probes);
+                return true;
+            }
+            if (arena[slots[slot]].state == state) {
+                note_probes(probes);
+                if (replace) {
+                    slots[slot] = node_index;
+                }
+                return false;
+            }
+        }
+    }
+
+    void grow() {
+        std::vector<uint32_t> old_slots(slots.size() * 2, NO_NODE);
+        old_slots.swap(slots);
+        mask = slots.size() - 1;
+        for (uint32_t node_index : old_slots) {
+            if (node_index == NO_NODE) {
+                continue;
+            }
+            size_t slot = arena[node_index].state.hash & mask;
+            while (slots[slot] != NO_NODE) {
+                slot = (slot + 1) & mask;
+            }
+            slots[slot] = node_index;
+        }
+    }
+
+    const NodeArena& arena;
+    std::vector<uint32_t> slots;
+    size_t mask;
+    size_t count = 0;
+};
+
+class ShardedStateTable { // Visited set shared by worker threads; each shard is an open-addressing table behind its own mutex
+public:
+    struct Entry {
+        PackedState state;
+        uint32_t parent; // Index of the parent in the previous BFS layer
+        uint8_t move;
+        uint8_t depth;
+        bool used;
+    };
+
+    explicit ShardedStateTable(int shard_bits)
+        : shard_shift(64 - shard_bits), shards(size_t(1) << shard_bits), sampled_slots(shards.size() * shards.front().slots.size()) {}
+
+    ~ShardedStateTable() {
+        size_t entries = 0;
+        size_t slots = 0;
+        for (const auto& shard : shards) {
+            entries += shard.count;
+            slots += shard.slots.size();
+        }
+        note_table(entries, slots);
+    }
+
+    // Insert a state first seen at depth, or, if it was already seen at that same depth, keep whichever parent
+    // prefers() ranks first. Returns true if the state was new.
+    template <typename Prefer>
+    bool insert(const PackedState& state, uint32_t parent, uint8_t move, int depth, Prefer prefers) {
+        Shard& shard = shard_for(state);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if ((shard.count + 1) * 2 > shard.slots.size()) {
+            sampled_slots.fetch_add(shard.slots.size(), std::memory_order_relaxed);
+            grow(shard);
+        }
+        Entry* entry = probe(shard, state);
+        if (entry->used) {
+            if (entry->depth == depth && prefers(parent, move, entry->parent, entry->move)) {
+                entry->parent = parent;
+                entry->move = move;
+            }
+            return false;
+        }
+        *entry = {state, parent, move, static_cast<uint8_t>(depth), true};
+        if (++shard.count % TABLE_NOTE_INTERVAL == 0) { // Totals move in steps, so no shared counter per insert
+            size_t entries = sampled_entries.fetch_add(TABLE_NOTE_INTERVAL, std::memory_order_relaxed) + TABLE_NOTE_INTERVAL;
+            note_table(entries, sampled_slots.load(std::memory_order_relaxed));
+        }
+        return true;
+    }
+
+    Entry find(const PackedState& state) { // Entry for a state; used is false if absent
+        Shard& shard = shard_for(state);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return *probe(shard, state);
+    }
+
+    size_t size() {
+        size_t total = 0;
+        for (auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            total += shard.count;
+        }
+        return total;
+    }
+
+private:
+    struct Shard {
+        std::mutex mutex;
+        std::vector<Entry> slots = std::vector<Entry>(64);
+        size_t count = 0;
+    };
+
+    Shard& shard_for(const PackedState& state) { // High hash bits pick the shard, low bits the slot
+        return shards[state.hash >> shard_shift];
+    }
+
+    static Entry* probe(Shard& shard, const PackedState& state, bool counted = true) {
+        size_t mask = shard.slots.size() - 1;
+        for (size_t slot = state.hash & mask, probes = 1;; slot = (slot + 1) & mask, ++probes) {
+            Entry& entry = shard.slots[slot];
+            if (!entry.used || entry.state == state) {
+                if (counted) {
+                    note_probes(probes);
+                }
+                return &entry;
+            }
+        }
+    }
+
+    static void grow(Shard& shard) {
+        std::vector<Entry> old_slots(shard.slots.size() * 2);
+        old_slots.swap(shard.slots);
+        for (const auto& entry : old_slots) {
+            if (entry.used) {
+                *probe(shard, entry.state, false) = entry;
+            }
+        }
+    }
+
+    int shard_shift;
+    std::vector<Shard> shards;
+    std::atomic<size_t> sampled_entries{0}; // Entries counted in whole TABLE_NOTE_INTERVAL steps per shard
+    std::atomic<size_t> sampled_slots{0}; // Slots of all shards, kept up to date as they grow
+};
+
+// Open list for small integer costs: a stack of node handles per (f, h) bucket, popped lowest f first and lowest h
+// within it, so ties go to the node nearest a goal. Push and pop are O(1) apart from skipping empty buckets, which
+// only happens as the cursors move up. Entries are never removed early; callers drop stale ones when popped.
+class BucketQueue {
+public:
+    void push(uint32_t handle, int f_cost, int h_cost) {
+        if (f_cost >= static_cast<int>(buckets.size())) {
+            buckets.resize(f_cost + 1);
+        }
+        Level& level = buckets[f_cost];
+        if (h_cost >= static_cast<int>(level.by_h.size())) {
+            level.by_h.resize(h_cost + 1);
+        }
+        level.by_h[h_cost].push_back(handle);
+        level.min_h = std::min(level.min_h, h_cost);
+        level.count++;
+        min_f = std::min(min_f, f_cost);
+        count++;
+        peak_count = std::max(peak_count, count);
+    }
+
+    uint32_t pop() { // The queue must not be empty
+        while (buckets[min_f].count == 0) {
+            min_f++;
+        }
+        Level& level = buckets[min_f];
+        while (level.by_h[level.min_h].empty()) {
+            level.min_h++;
+        }
+        std::vector<uint32_t>& bucket = level.by_h[level.min_h];
+        uint32_t handle = bucket.back();
+        bucket.pop_back();
+        level.count--;
+        count--;
+        return handle;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    size_t peak_size() const {
+        return peak_count;
+    }
+
+    size_t memory_bytes() const { // Bucket storage currently reserved; buckets never shrink, so this is also the peak
+        size_t bytes = buckets.capacity() * sizeof(Level);
+        for (const auto& level : buckets) {
+            bytes += level.by_h.capacity() * sizeof(std::vector<uint32_t>);
+            for (const auto& bucket : level.by_h) {
+                bytes += bucket.capacity() * sizeof(uint32_t);
+            }
+        }
+        return bytes;
+    }
+
+private:
+    struct Level { // All entries sharing one f-cost
+        std::vector<std::vector<uint32_t>> by_h;
+        int min_h = std::numeric_limits<int>::max(); // No bucket below this holds entries
+        size_t count = 0;
+    };
+
+    std::vector<Level> buckets;
+    int min_f = std::numeric_limits<int>::max();
+    size_t count = 0;
+    size_t peak_count = 0;
+};
+
+// Forward declarations
+bool has_realizable_path(const Position& start, const Position& goal, const Board& board, const PackedState& state);
+bool are_interacting(const Position& pos1, const Position& pos2, const Position& goal1, const Position& goal2);
+
+// Standard heuristic function for A* algorithm
+int standard_heuristic(const Board& board, const PackedState& state, const PackedState& goal_state) {
+    int total_distance = 0;
+    for (int i = 0; i < board.num_words; ++i) {
+        Position pos = board.position(state.cells[i]);
+        int min_distance = std::numeric_limits<int>::max();
+        for (int j = 0; j < board.num_words; ++j) {
+            Position possible_goal = board.position(goal_state.cells[j]);
+            int dx = std::abs(pos.first - possible_goal.first);
+            int dy = std::abs(pos.second - possible_goal.second);
+            min_distance = std::min(min_distance, dx + dy);
+        }
+        total_distance += min_distance;
+    }
+    return total_distance;
+}
+
+// Goal state count heuristic
+int goal_count_heuristic(const Board& board, const PackedState& state, const PackedState& goal_state) {
+    int count = 0;
+    for (int i = 0; i < board.num_words; ++i) {
+        for (int j = 0; j < board.num_words; ++j) {
+            if (state.cells[i] == goal_state.cells[j]) {
+                count++;
+                break;
+            }
+        }
+    }
+    return board.num_words - count;
+}
+
+// Number of Realizable Generalized Paths (NRP) heuristic
+int nrp_heuristic(const Board& board, const PackedState& state, const PackedState& goal_state) {
+    int count = 0;
+    for (int i = 0; i < board.num_words; ++i) {
+        bool has_path = false;
+        for (int j = 0; j < board.num_words; ++j) {
+            if (has_realizable_path(board.position(state.cells[i]), board.position(goal_state.cells[j]), board, state)) {
+                has_path = true;
+                break;
+            }
+        }
+        if (has_path) {
+            count++;
+        }
+    }
+    return board.num_words - count;
+}
+
+// Linear conflicts word_index would have at cell_index with the other words of state, for one goal placement. Two
+// words on the placement's row or column in the reverse of their target order cannot pass each other there, so
+// one of them must leave the line and come back: two slides at least. Only pairs whose words are both within one
+// slide of their targets count, as those are the pairs where that costs more than the slide distances do.
+template <int Words = 0>
+int linear_conflict_pairs(const Board& board, const PackedState& state, int placement, int word_index, int cell_index) {
+    Bitboard line = board.placement_line[placement];
+    auto in_reach = [&](int i, int cell_index) { // On the line and at most one slide from the target
+        return (line & cell_bit(cell_index)) && board.placement_cost[board.placement_row(i, cell_index) + placement] <= 1;
+    };
+    if (!in_reach(word_index, cell_index)) {
+        return 0;
+    }
+    int step = board.placement_horizontal[placement] ? 1 : board.cols; // Cell indices grow along the line in either case
+    const PackedState& goal_state = board.goal_states[placement];
+    int pairs = 0;
+    for (int i = 0; i < board.word_count<Words>(); ++i) {
+        if (i != word_index && in_reach(i, state.cells[i]) &&
+            (cell_index - state.cells[i]) / step * ((goal_state.cells[word_index] - goal_state.cells[i]) / step) < 0) {
+            pairs++;
+        }
+    }
+    return pairs;
+}
+
+// Linear Conflict heuristic: one slide on top of a placement's summed slide distances when any pair of words is in
+// linear conflict. One word leaving the line may clear every conflict it is part of, so they do not add up.
+int linear_conflict_heuristic(const Board& board, const PackedState& state, int placement) {
+    for (int i = 0; i < board.num_words; ++i) {
+        if (linear_conflict_pairs(board, state, placement, i, state.cells[i])) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Manhattan Distance with Sliding heuristic
+int manhattan_sliding_heuristic(const Board& board, const PackedState& state, const PackedState& goal_state) {
+    int total_distance = 0;
+    for (int i = 0; i < board.num_words; ++i) {
+        Position pos = board.position(state.cells[i]);
+        Position goal = board.position(goal_state.cells[i]);
+        int dx = std::abs(goal.first - pos.first);
+        int dy = std::abs(goal.second - pos.second);
+        total_distance += std::max(dx, dy);
+    }
+    return total_distance;
+}
+
+// Interaction Cost heuristic. Not a lower bound: every goal placement scores a cost for its own words sharing a
+// line. Its admissible part, a word in the way of another on their common line, is what linear_conflict_pairs counts.
+int interaction_cost_heuristic(const Board& board, const PackedState& state, const PackedState& goal_state) {
+    int cost = 0;
+    for (int i = 0; i < board.num_words; ++i) {
+        for (int j = i + 1; j < board.num_words; ++j) {
+            if (are_interacting(board.position(state.cells[i]), board.position(state.cells[j]),
+                                board.position(goal_state.cells[i]), board.position(goal_state.cells[j]))) {
+                cost++;
+            }
+        }
+    }
+    return cost;
+}
+
+// Helper function for NRP heuristic
+bool has_realizable_path(const Position& start, const Position& goal, const Board& board, const PackedState& state) {
+    // Simplified check: consider a path realizable if there are no obstacles in the way
+    int dx = goal.first - start.first;
+    int dy = goal.second - start.second;
+    int steps = std::max(std::abs(dx), std::abs(dy));
+    for (int i = 1; i <= steps; ++i) {
+        int x = start.first + (dx * i) / steps;
+        int y = start.second + (dy * i) / steps;
+        if (board.is_occupied(state, {x, y})) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Helper function for Interaction Cost heuristic
+bool are_interacting(const Position& pos1, const Position& pos2, const Position& goal1, const Position& goal2) {
+    return pos1.first == pos2.first || pos1.second == pos2.second;
+}
+
+// Placement-aware slide heuristic: the cheapest goal placement, in either orientation, by summed per-word
+// slide distances plus its linear conflict. Each move slides one word, so the sum never overestimates.
+int placement_heuristic(const Board& board, const PackedState& state, int* best_placement = nullptr) {
+    int best = DEAD_STATE_COST;
+    for (size_t placement = 0; placement < board.goal_states.size(); ++placement) {
+        const PackedState& goal_state = board.goal_states[placement];
+        int total = 0;
+        for (int i = 0; i < board.num_words && total < best; ++i) {
+            uint8_t distance = board.slide_distance[goal_state.cells[i]][state.cells[i]];
+            total += distance == UNREACHABLE ? DEAD_STATE_COST : distance;
+        }
+        if (total < best) {
+            total += linear_conflict_heuristic(board, state, static_cast<int>(placement));
+        }
+        if (total < best) {
+            best = total;
+            if (best_placement) {
+                *best_placement = static_cast<int>(placement);
+            }
+        }
+    }
+    return best;
+}
+
+// Kernels over placement cost rows, each lanes int16 values (a multiple of PLACEMENT_LANE_BLOCK). accumulate adds a
+// row into totals; swap_min returns the smallest lane of totals - removed + added, all lanes being non-negative.
+struct PlacementKernels {
+    const char* name;
+    void (*accumulate)(int16_t* totals, const int16_t* row, int lanes);
+    int (*swap_min)(const int16_t* totals, const int16_t* removed, const int16_t* added, int lanes);
+};
+
+void accumulate_scalar(int16_t* totals, const int16_t* row, int lanes) {
+    for (int lane = 0; lane < lanes; ++lane) {
+        totals[lane] = static_cast<int16_t>(totals[lane] + row[lane]);
+    }
+}
+
+int swap_min_scalar(const int16_t* totals, const int16_t* removed, const int16_t* added, int lanes) {
+    int best = std::numeric_limits<int16_t>::max();
+    for (int lane = 0; lane < lanes; ++lane) {
+        best = std::min(best, totals[lane] - removed[lane] + added[lane]);
+    }
+    return best;
+}
+
+#if defined(__x86_64__) && defined(__GNUC__)
+__attribute__((target("sse4.1"))) void accumulate_sse41(int16_t* totals, const int16_t* row, int lanes) {
+    for (int lane = 0; lane < lanes; lane += 8) {
+        __m128i sum = _mm_add_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(totals + lane)),
+                                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + lane)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(totals + lane), sum);
+    }
+}
+
+__attribute__((target("sse4.1"))) int swap_min_sse41(const int16_t* totals, const int16_t* removed, const int16_t* added, int lanes) {
+    __m128i best = _mm_set1_epi16(std::numeric_limits<int16_t>::max());
+    for (int lane = 0; lane < lanes; lane += 8) {
+        __m128i total = _mm_sub_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(totals + lane)),
+                                      _mm_loadu_si128(reinterpret_cast<const __m128i*>(removed + lane)));
+        total = _mm_add_epi16(total, _mm_loadu_si128(reinterpret_cast<const __m128i*>(added + lane)));
+        best = _mm_min_epi16(best, total);
+    }
+    return _mm_extract_epi16(_mm_minpos_epu16(best), 0);
+}
+
+__attribute__((target("avx2"))) void accumulate_avx2(int16_t* totals, const int16_t* row, int lanes) {
+    for (int lane = 0; lane < lanes; lane += 16) {
+        __m256i sum = _mm256_add_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(totals + lane)),
+                                       _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + lane)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(totals + lane), sum);
+    }
+}
+
+__attribute__((target("avx2"))) int swap_min_avx2(const int16_t* totals, const int16_t* removed, const int16_t* added, int lanes) {
+    __m256i best = _mm256_set1_epi16(std::numeric_limits<int16_t>::max());
+    for (int lane = 0; lane < lanes; lane += 16) {
+        __m256i total = _mm256_sub_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(totals + lane)),
+                                         _mm256_loadu_si256(reinterpret_cast<const __m256i*>(removed + lane)));
+        total = _mm256_add_epi16(total, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(added + lane)));
+        best = _mm256_min_epi16(best, total);
+    }
+    __m128i half = _mm_min_epi16(_mm256_castsi256_si128(best), _mm256_extracti128_si256(best, 1));
+    return _mm_extract_epi16(_mm_minpos_epu16(half), 0);
+}
+#endif
+
+PlacementKernels select_placement_kernels() { // Widest kernels the running CPU supports
+#if defined(__x86_64__) && defined(__GNUC__)
+    if (__builtin_cpu_supports("avx2")) {
+        return {"avx2", accumulate_avx2, swap_min_avx2};
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return {"sse4.1", accumulate_sse41, swap_min_sse41};
+    }
+#endif
+    return {"scalar", accumulate_scalar, swap_min_scalar};
+}
+
+const PlacementKernels placement_kernels = select_placement_kernels();
+
+// Combined heuristic function
+int combined_heuristic(const Board& board, const PackedState& state, int* best_placement = nullptr) {
+    StatsBlock& stats = stats_block();
+    SampledTimer timer(stats.heuristic_calls, stats.heuristic_sampled_ns);
+    return std::max({
+        placement_heuristic(board, state, best_placement),
+        board.pattern_database ? board.pattern_database->lookup(state) : 0,
+        //standard_heuristic(board, state, goal_state),
+        //goal_count_heuristic(board, state, goal_state),
+        //manhattan_sliding_heuristic(board, state, goal_state),
+        //interaction_cost_heuristic(board, state, goal_state),
+        //nrp_heuristic(board, state, goal_state),
+    });
+}
+
+const uint8_t CONFLICTS_UNKNOWN = 0xFF; // Pair count of a placement HeuristicTerms has not needed yet
+
+// Per-node terms of the placement heuristic, from which each successor's value follows by updating only the terms
+// of the word it moves: per placement, the summed slide costs of all words and the number of word pairs in linear
+// conflict. A successor's totals are the node's with one cost row swapped, and its pair count is the node's less
+// the moved word's pairs at its old cell plus its pairs at the new one, O(num_words). The conflict adds at most
+// one slide, so pair counts are only needed on placements where a successor's totals are smallest; the node's
+// counts are filled in on first use.
+template <int Words = 0>
+struct HeuristicTerms {
+    const Board& board;
+    const PackedState& state;
+    std::vector<int16_t>& totals;
+    std::vector<uint8_t>& conflicts;
+
+    HeuristicTerms(const Board& board, const PackedState& state, std::vector<int16_t>& totals, std::vector<uint8_t>& conflicts)
+        : board(board), state(state), totals(totals), conflicts(conflicts) {
+        totals.assign(board.placement_lanes, 0);
+        for (int i = 0; i < board.word_count<Words>(); ++i) {
+            placement_kernels.accumulate(totals.data(), board.placement_cost.data() + board.placement_row(i, state.cells[i]), board.placement_lanes);
+        }
+        conflicts.assign(board.placement_lanes, CONFLICTS_UNKNOWN);
+    }
+
+    int node_conflicts(int placement) { // Pairs in linear conflict at the node itself
+        if (conflicts[placement] == CONFLICTS_UNKNOWN) {
+            int pairs = 0;
+            for (int i = 0; i < board.word_count<Words>(); ++i) {
+                pairs += linear_conflict_pairs<Words>(board, state, placement, i, state.cells[i]);
+            }
+            conflicts[placement] = static_cast<uint8_t>(pairs / 2);
+        }
+        return conflicts[placement];
+    }
+
+    int successor(int word_index, int to) { // Placement heuristic of the node with word_index moved to cell to
+        const int16_t* removed = board.placement_cost.data() + board.placement_row(word_index, state.cells[word_index]);
+        const int16_t* added = board.placement_cost.data() + board.placement_row(word_index, to);
+        int best = placement_kernels.swap_min(totals.data(), removed, added, board.placement_lanes);
+        if (best >= DEAD_STATE_COST) {
+            return DEAD_STATE_COST;
+        }
+        for (int placement = 0; placement < static_cast<int>(board.goal_states.size()); ++placement) {
+            if (totals[placement] - removed[placement] + added[placement] == best &&
+                node_conflicts(placement) - linear_conflict_pairs<Words>(board, state, placement, word_index, state.cells[word_index]) +
+                        linear_conflict_pairs<Words>(board, state, placement, word_index, to) == 0) {
+                return best; // A cheapest placement without a conflict
+            }
+        }
+        return best + 1;
+    }
+};
+
+// combined_heuristic of every successor in moves, written to h_costs at its move code. The parent's
+// HeuristicTerms are built once and each successor updates them for the one word it moves.
+template <int Words = 0>
+void combined_heuristic_batch(const Board& board, const PackedState& state,
+                              const std::array<PackedState, MAX_WORDS * NUM_DIRECTIONS>& successors, uint64_t moves,
+                              std::array<int, MAX_WORDS * NUM_DIRECTIONS>& h_costs) {
+    StatsBlock& stats = stats_block();
+    SampledTimer timer(stats.heuristic_calls, stats.heuristic_sampled_ns);
+    thread_local std::vector<int16_t> totals;
+    thread_local std::vector<uint8_t> conflicts;
+    HeuristicTerms<Words> terms(board, state, totals, conflicts);
+    for (; moves; moves &= moves - 1) {
+        int move = std::countr_zero(moves);
+        int word_index = move / NUM_DIRECTIONS;
+        const PackedState& successor = successors[move];
+        int placement = terms.successor(word_index, successor.cells[word_index]);
+        h_costs[move] = std::max(placement, board.pattern_database ? board.pattern_database->lookup(successor) : 0);
+    }
+}
+
+// Tie-breaker for equal f-costs: scaled Manhattan distance of each word to its goal cell
+double goal_tie_breaker(const Board& board, const PackedState& state, const PackedState& goal_state) {
+    double tie_breaker = 0.0;
+    for (int i = 0; i < board.num_words; ++i) {
+        Position pos = board.position(state.cells[i]);
+        Position goal = board.position(goal_state.cells[i]);
+        tie_breaker += std::abs(pos.first - goal.first) + std::abs(pos.second - goal.second);
+    }
+    return tie_breaker / 1000.0; // Scale down the tie-breaker value
+}
+
+SolveResult solve_game_ida_star_beam(const Board& board, int max_paths = MAX_PATHS_TRAVERSED, const StopToken* stop = nullptr) {
+    struct Node { // Beam entry; state, depth and path live in the arena
+        uint32_t index;
+        int f_cost;
+        double tie_breaker;
+    };
+
+    NodeArena arena;
+    NodeTable visited(arena);
+    int depth_limit = INITIAL_DEPTH_LIMIT;
+    int paths_traversed = 0;
+
+    while (paths_traversed < max_paths) {
+        arena.clear();
+        visited.clear();
+        uint32_t root = arena.add(board.initial, NO_NODE, 0, 0);
+        std::vector<Node> beam = {{root, combined_heuristic(board, board.initial), 0.0}};
+        std::vector<Node> next_beam;
+
+        while (!beam.empty() && paths_traversed < max_paths) {
+            next_beam.clear();
+
+            for (const auto& current : beam) {
+                const ArenaNode& node = arena[current.index];
+                paths_traversed++;
+                if (should_stop(stop, paths_traversed)) {
+                    return {paths_traversed, {}};
+                }
+                note_expansion(node.depth);
+
+                if (board.is_goal(node.state)) {
+                    MovePath path = arena.path_to(current.index);
+                    print_solution(path);
+                    return {paths_traversed, path};
+                }
+
+                if (node.depth >= depth_limit) continue;
+
+                std::array<PackedState, MAX_WORDS * NUM_DIRECTIONS> successors;
+                int successor_count = board.generate_successors(node.state, successors);
+                for (int move = 0; move < successor_count; ++move) { // Successor order matches the move codes
+                    const PackedState& new_state = successors[move];
+                    if (board.is_dead(new_state)) {
+                        note_dead_state();
+                        continue;
+                    }
+
+                    uint32_t seen = visited.find(new_state);
+                    if (seen != NO_NODE && arena[seen].depth <= node.depth + 1) {
+                        note_duplicate();
+                        continue;
+                    }
+
+                    int new_g_cost = node.depth + 1;
+                    int best_placement = 0;
+                    int new_f_cost = new_g_cost + combined_heuristic(board, new_state, &best_placement);
+                    if (new_f_cost >= incumbent_bound(stop)) {
+                        continue;
+                    }
+                    double new_tie_breaker = goal_tie_breaker(board, new_state, board.goal_states[best_placement]);
+
+                    uint32_t child = arena.add(new_state, current.index, static_cast<uint8_t>(move), new_g_cost);
+                    next_beam.push_back({child, new_f_cost, new_tie_breaker});
+                    visited.assign(child);
+                }
+            }
+
+            std::sort(next_beam.begin(), next_beam.end(), 
+                [](const Node& a, const Node& b) { return a.f_cost < b.f_cost || (a.f_cost == b.f_cost && a.tie_breaker < b.tie_breaker); });
+
+            beam.assign(next_beam.begin(), next_beam.begin() + std::min(static_cast<size_t>(BEAM_WIDTH), next_beam.size()));
+            note_open_size(beam.size());
+        }
+
+        depth_limit += 5;
+    }
+
+    return {paths_traversed, {}};
+}
+
+template <int Words = 0>
+SolveResult solve_game_astar(const Board& board, int max_paths = MAX_PATHS_TRAVERSED, const StopToken* stop = nullptr) {
+    auto start_time = std::chrono::steady_clock::now();
+    NodeArena arena;
+    BucketQueue open_list; // Arena indices bucketed by f-cost, then h-cost
+    NodeTable closed_list(arena);
+    std::atomic<long long> pop_calls{0}; // Pops and push batches each have one call in STATS_TIMING_SAMPLE timed
+    std::atomic<long long> pop_sampled_ns{0};
+    std::atomic<long long> push_calls{0};
+    std::atomic<long long> push_sampled_ns{0};
+
+    auto report_open_list = [&]() {
+        std::chrono::duration<double> total_time = std::chrono::steady_clock::now() - start_time;
+        // Scaled up from sampled calls, so one preempted sample can overshoot a short search; cap it at the whole
+        double open_list_seconds = std::min(total_time.count(), SearchStatsSnapshot::estimated_seconds(pop_calls, pop_sampled_ns) +
+                                                                    SearchStatsSnapshot::estimated_seconds(push_calls, push_sampled_ns));
+        std::ostringstream stats; // Formatted apart from std::cout so the fixed precision does not stick
+        stats << "Level " << board.level << ": Open list peak " << open_list.peak_size() << " entries, " << std::fixed
+              << std::setprecision(2) << open_list.memory_bytes() / (1024.0 * 1024.0) << " MB, "
+              << std::setprecision(3) << open_list_seconds << " s of " << total_time.count() << " s in push/pop";
+        std::lock_guard<std::mutex> lock(cout_mutex);
+        std::cout << stats.str() << std::endl;
+    };
+
+    uint32_t root = arena.add(board.initial, NO_NODE, 0, 0);
+    int initial_h_cost = combined_heuristic(board, board.initial);
+    open_list.push(root, initial_h_cost, initial_h_cost);
+
+    int paths_traversed = 0;
+
+    while (!open_list.empty() && paths_traversed < max_paths) {
+        uint32_t current_index;
+        {
+            SampledTimer timer(pop_calls, pop_sampled_ns);
+            current_index = open_list.pop();
+        }
+        const ArenaNode& node = arena[current_index];
+
+        // Lazy deletion: skip entries whose state was already expanded at least as cheaply. A same-depth copy from
+        // another parent still goes through, since move pruning may have skipped moves it allows.
+        uint32_t closed = closed_list.find(node.state);
+        if (closed != NO_NODE) {
+            const ArenaNode& closed_node = arena[closed];
+            if (closed_node.depth < node.depth ||
+                (closed_node.depth == node.depth && (!board.move_pruning || closed_node.parent == node.parent))) {
+                continue;
+            }
+        }
+        paths_traversed++;
+        if (should_stop(stop, paths_traversed)) {
+            break;
+        }
+        note_expansion(node.depth);
+
+        if (board.is_goal(node.state)) {
+            MovePath path = arena.path_to(current_index);
+            print_solution(path);
+            report_open_list();
+            return {paths_traversed, path};
+        }
+
+        closed_list.assign(current_index);
+
+        std::array<PackedState, MAX_WORDS * NUM_DIRECTIONS> successors;
+        int successor_count = board.generate_successors<Words>(node.state, successors);
+        auto [last_move, last_from] = arena.last_move(current_index);
+        uint64_t moves = board.useful_moves<Words>(node.state, successors, last_move, last_from);
+        std::array<int, MAX_WORDS * NUM_DIRECTIONS> h_costs;
+        combined_heuristic_batch<Words>(board, node.state, successors, moves, h_costs);
+        std::array<std::array<int, 3>, MAX_WORDS * NUM_DIRECTIONS> children; // Arena index, f-cost, h-cost
+        int child_count = 0;
+        for (int move = 0; move < successor_count; ++move) { // Successor order matches the move codes
+            if (!(moves >> move & 1)) {
+                continue;
+            }
+            const PackedState& new_state = successors[move];
+            if (board.is_dead<Words>(new_state)) {
+                note_dead_state();
+                continue;
+            }
+
+            uint32_t closed = closed_list.find(new_state);
+            if (closed != NO_NODE) {
+                // A closed state reached again at the same depth from another parent was expanded with a
+                // different set of pruned moves, so it is queued again rather than losing the moves it skipped
+                const ArenaNode& closed_node = arena[closed];
+                if (!board.move_pruning || closed_node.depth != node.depth + 1 || closed_node.parent == current_index) {
+                    note_duplicate();
+                    continue;
+                }
+            }
+
+            int new_g_cost = node.depth + 1;
+            int new_h_cost = h_costs[move];
+            if (new_g_cost + new_h_cost >= incumbent_bound(stop)) {
+                continue;
+            }
+            uint32_t child = arena.add(new_state, current_index, static_cast<uint8_t>(move), new_g_cost);
+            children[child_count++] = {static_cast<int>(child), new_g_cost + new_h_cost, new_h_cost};
+        }
+
+        {
+            SampledTimer timer(push_calls, push_sampled_ns);
+            for (int i = 0; i < child_count; ++i) {
+                open_list.push(static_cast<uint32_t>(children[i][0]), children[i][1], children[i][2]);
+            }
+        }
+        note_open_size(open_list.size());
+    }
+
+    report_open_list();
+    return {paths_traversed, {}};
+}
+
+template <int Words = 0>
+SolveResult solve_game_ida_star(const Board& board, int max_paths = MAX_PATHS_TRAVERSED, const StopToken* stop = nullptr) {
+    // Depth-first IDA*: memory is the current path plus a fixed-size transposition table. The table is lossy;
+    // a slot keeps the most recent state hashed to it and the smallest depth it was reached at this iteration.
+    // It also records which moves were searched, since a visit at the same depth through a different last move
+    // prunes a different set and only the moves not yet searched from there need another look.
+    struct TableEntry {
+        std::array<uint8_t, MAX_WORDS> cells;
+        uint64_t searched_moves;
+        uint16_t iteration;
+        uint8_t depth;
+    };
+    const size_t table_mask = (size_t(1) << TRANSPOSITION_TABLE_BITS) - 1;
+    std::vector<TableEntry> table(table_mask + 1, TableEntry{{}, 0, 0, 0});
+
+    const int FOUND = -1;
+    const int NOT_FOUND = std::numeric_limits<int>::max();
+    int paths_traversed = 0;
+    uint16_t iteration = 0;
+    std::vector<uint8_t> path_moves;
+
+    // Returns FOUND, or the smallest f-cost that exceeded the bound below this node
+    std::function<int(const PackedState&, int, int, int, uint8_t, uint8_t)> search = [&](const PackedState& state, int g_cost, int h_cost,
+                                                                                       int bound, uint8_t last_move, uint8_t last_from) {
+        int f_cost = g_cost + h_cost;
+        if (f_cost >= incumbent_bound(stop)) {
+            return NOT_FOUND; // Cannot beat a solution another search already has
+        }
+        if (f_cost > bound) {
+            return f_cost;
+        }
+        if (board.is_goal(state)) {
+            return FOUND;
+        }
+
+        TableEntry& entry = table[state.hash & table_mask];
+        bool revisit = entry.iteration == iteration && entry.cells == state.cells;
+        if (revisit && entry.depth < g_cost) {
+            note_duplicate();
+            return NOT_FOUND; // Already searched from here with more budget this iteration
+        }
+
+        std::array<PackedState, MAX_WORDS * NUM_DIRECTIONS> successors;
+        int successor_count = board.generate_successors<Words>(state, successors);
+        uint64_t moves = board.useful_moves<Words>(state, successors, last_move, last_from);
+        if (revisit && entry.depth == g_cost) {
+            moves &= ~entry.searched_moves;
+            if (!moves) {
+                note_duplicate();
+                return NOT_FOUND; // Every remaining move was searched from here with the same budget
+            }
+            entry.searched_moves |= moves;
+        } else {
+            entry = {state.cells, moves, iteration, static_cast<uint8_t>(g_cost)};
+        }
+
+        note_expansion(g_cost);
+        if (++paths_traversed >= max_paths || should_stop(stop, paths_traversed)) {
+            max_paths = paths_traversed; // Unwinds every frame and ends the iteration loop
+            return NOT_FOUND;
+        }
+
+        std::array<int, MAX_WORDS * NUM_DIRECTIONS> h_costs;
+        combined_heuristic_batch<Words>(board, state, successors, moves, h_costs);
+        int min_exceeded = NOT_FOUND;
+        for (int move = 0; move < successor_count; ++move) { // Successor order matches the move codes
+            if (!(moves >> move & 1) || successors[move] == state) {
+                continue; // Pruned, or the word was already against a blocker
+            }
+            path_moves.push_back(static_cast<uint8_t>(move));
+            uint8_t from = state.cells[move / NUM_DIRECTIONS];
+            int result = search(successors[move], g_cost + 1, h_costs[move], bound, static_cast<uint8_t>(move), from);
+            if (result == FOUND) {
+                return FOUND;
+            }
+            path_moves.pop_back();
+            min_exceeded = std::min(min_exceeded, result);
+        }
+        return min_exceeded;
+    };
+
+    int bound = combined_heuristic(board, board.initial);
+    while (bound < DEAD_STATE_COST && bound <= MAX_PATH_LENGTH && paths_traversed < max_paths) {
+        iteration++;
+        int result = search(board.initial, 0, combined_heuristic(board, board.initial), bound, NO_MOVE, NO_CELL);
+        if (result == FOUND) {
+            MovePath path;
+            for (uint8_t move : path_moves) {
+                path.emplace_back(move / NUM_DIRECTIONS, DIRECTIONS[move % NUM_DIRECTIONS].first);
+            }
+            print_solution(path);
+            return {paths_traversed, path};
+        }
+        bound = result;
+    }
+
+    return {paths_traversed, {}};
+}
+
+const std::array<int, 6> ARA_WEIGHTS = {50, 30, 20, 15, 12, 10}; // Heuristic weight of each ARA* pass, in tenths
+const double ARA_TIME_BUDGET_SECONDS = 60; // Wall-clock budget of the anytime search when the caller gives none
+
+SolveResult solve_game_ara_star(const Board& board, double time_budget = ARA_TIME_BUDGET_SECONDS,
+                                int max_paths = MAX_PATHS_TRAVERSED, const StopToken* stop = nullptr) {
+    // Anytime repairing A* (ARA*): weighted A* passes with a falling weight. Each pass keeps the g-costs and
+    // parents of the ones before. A closed state whose g-cost improves goes on an inconsistent list instead of
+    // being expanded again, and the next pass starts from the open and inconsistent states rekeyed under its
+    // weight. Every better solution is printed as soon as it is found, along with the best lower bound proven
+    // so far: the smallest unweighted f-cost left open or inconsistent after a pass. The last pass has weight 1,
+    // so a run that finishes it has proven its solution optimal.
+    auto start_time = std::chrono::steady_clock::now();
+    auto deadline = start_time + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(time_budget));
+    NodeArena arena;
+    NodeTable nodes(arena);
+    std::vector<uint16_t> h_costs; // Indexed like the arena
+    std::vector<uint8_t> closed_pass; // Pass that last expanded a node, 0 if none
+    std::vector<uint8_t> open_pass; // Pass whose open_members last took a node
+    std::vector<uint8_t> inconsistent_pass; // Pass whose inconsistent list last took a node
+    std::vector<uint32_t> open_members; // Everything pushed this pass; closed ones are filtered out when rekeying
+    std::vector<uint32_t> inconsistent;
+    uint32_t incumbent = NO_NODE;
+    int incumbent_length = std::numeric_limits<int>::max(); // Kept apart, since reparenting shortens the incumbent in place
+    int lower_bound = 0;
+    int paths_traversed = 0;
+
+    auto elapsed = [&]() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    };
+    auto publish = [&](const char* event, int weight) {
+        std::lock_guard<std::mutex> lock(cout_mutex);
+        std::cout << "Level " << board.level << ": ARA* " << event << ", length "
+                  << (incumbent == NO_NODE ? std::string("-") : std::to_string(arena[incumbent].depth))
+                  << ", lower bound " << lower_bound << ", weight " << weight / 10 << "." << weight % 10
+                  << ", " << paths_traversed << " paths, " << elapsed() << " s" << std::endl;
+    };
+    auto add_node = [&](const PackedState& state, uint32_t parent, uint8_t move, int depth) {
+        uint32_t index = arena.add(state, parent, move, depth);
+        nodes.insert(index);
+        h_costs.push_back(static_cast<uint16_t>(std::min(combined_heuristic(board, state), DEAD_STATE_COST)));
+        closed_pass.push_back(0);
+        open_pass.push_back(0);
+        inconsistent_pass.push_back(0);
+        return index;
+    };
+    auto offer_goal = [&](uint32_t index, int weight) {
+        if (arena[index].depth < incumbent_length) {
+            incumbent = index;
+            incumbent_length = arena[index].depth;
+            if (stop) {
+                stop->offer_incumbent(incumbent_length);
+            }
+            publish("found a solution", weight);
+        }
+    };
+
+    BucketQueue open_list;
+    uint32_t root = add_node(board.initial, NO_NODE, 0, 0);
+    lower_bound = h_costs[root];
+    if (board.is_goal(board.initial)) {
+        incumbent = root;
+        incumbent_length = 0;
+    } else if (h_costs[root] < DEAD_STATE_COST) {
+        open_list.push(root, ARA_WEIGHTS[0] * h_costs[root], h_costs[root]);
+        open_members.push_back(root);
+        open_pass[root] = 1;
+    }
+
+    bool stopped = false;
+    for (size_t pass_index = 0; pass_index < ARA_WEIGHTS.size() && !stopped; ++pass_index) {
+        uint8_t pass = static_cast<uint8_t>(pass_index + 1);
+        int weight = ARA_WEIGHTS[pass_index];
+        auto key = [&](uint32_t index) {
+            return 10 * arena[index].depth + weight * h_costs[index];
+        };
+
+        if (pass_index > 0) { // Rekey the states left open or inconsistent by the previous pass
+            std::vector<uint32_t> carried;
+            for (uint32_t index : open_members) {
+                if (closed_pass[index] != pass - 1) {
+                    carried.push_back(index);
+                }
+            }
+            carried.insert(carried.end(), inconsistent.begin(), inconsistent.end());
+            open_members.clear();
+            inconsistent.clear();
+            open_list = BucketQueue();
+            for (uint32_t index : carried) {
+                if (open_pass[index] != pass) {
+                    open_pass[index] = pass;
+                    open_list.push(index, key(index), h_costs[index]);
+                    open_members.push_back(index);
+                }
+            }
+        }
+
+        // Improve the incumbent until no open state could beat it under this pass's weight
+        while (!open_list.empty()) {
+            uint32_t current_index = open_list.pop();
+            if (closed_pass[current_index] == pass) {
+                continue; // Stale entry left behind when the state's g-cost improved
+            }
+            if (incumbent != NO_NODE && 10 * arena[incumbent].depth <= key(current_index)) {
+                open_list.push(current_index, key(current_index), h_costs[current_index]);
+                break;
+            }
+            if (++paths_traversed >= max_paths || (paths_traversed % STOP_POLL_INTERVAL == 0 &&
+                                                   (std::chrono::steady_clock::now() >= deadline || (stop && stop->stop_requested())))) {
+                stopped = true;
+                break;
+            }
+            closed_pass[current_index] = pass;
+            note_expansion(arena[current_index].depth);
+            note_open_size(open_list.size());
+
+            std::array<PackedState, MAX_WORDS * NUM_DIRECTIONS> successors;
+            PackedState state = arena[current_index].state;
+            int successor_count = board.generate_successors(state, successors);
+            uint64_t moves = board.useful_moves(state, successors, NO_MOVE, NO_CELL); // Only null moves; parents change
+            int new_g_cost = arena[current_index].depth + 1;
+            for (int move = 0; move < successor_count; ++move) { // Successor order matches the move codes
+                if (!(moves >> move & 1)) {
+                    continue;
+                }
+                uint32_t child = nodes.find(successors[move]);
+                if (child == NO_NODE) {
+                    child = add_node(successors[move], current_index, static_cast<uint8_t>(move), new_g_cost);
+                } else if (new_g_cost < arena[child].depth) {
+                    arena.reparent(child, current_index, static_cast<uint8_t>(move), new_g_cost);
+                } else {
+                    note_duplicate();
+                    continue;
+                }
+                if (board.is_goal(successors[move])) {
+                    offer_goal(child, weight);
+                } else if (h_costs[child] >= DEAD_STATE_COST || new_g_cost + h_costs[child] >= incumbent_bound(stop)) {
+                    continue;
+                } else if (closed_pass[child] == pass) {
+                    if (inconsistent_pass[child] != pass) {
+                        inconsistent_pass[child] = pass;
+                        inconsistent.push_back(child);
+                    }
+                } else {
+                    open_list.push(child, key(child), h_costs[child]);
+                    if (open_pass[child] != pass) {
+                        open_pass[child] = pass;
+                        open_members.push_back(child);
+                    }
+                }
+            }
+        }
+        if (stopped) {
+            break;
+        }
+
+        // Everything not yet settled is open or inconsistent, so its smallest g + h bounds the optimum
+        int frontier_bound = DEAD_STATE_COST;
+        for (uint32_t index : open_members) {
+            if (closed_pass[index] != pass) {
+                frontier_bound = std::min(frontier_bound, arena[index].depth + h_costs[index]);
+            }
+        }
+        for (uint32_t index : inconsistent) {
+            frontier_bound = std::min(frontier_bound, arena[index].depth + h_costs[index]);
+        }
+        if (incumbent != NO_NODE) {
+            frontier_bound = std::min<int>(frontier_bound, arena[incumbent].depth);
+        }
+        frontier_bound = std::min(frontier_bound, incumbent_bound(stop)); // States pruned against a shared incumbent
+        lower_bound = std::max(lower_bound, frontier_bound);
+        publish("finished a pass", weight);
+        if (incumbent == NO_NODE ? frontier_bound >= DEAD_STATE_COST : lower_bound >= arena[incumbent].depth) {
+            break; // Proven optimal, or no solution exists
+        }
+    }
+
+    if (incumbent == NO_NODE) {
+        return {paths_traversed, {}};
+    }
+    MovePath path = arena.path_to(incumbent);
+    print_solution(path);
+    bool proven = lower_bound >= static_cast<int>(path.size());
+    std::ostringstream line;
+    line << "Level " << board.level << ": ARA* "
+         << (proven ? "proved the solution optimal" : "stopped with lower bound " + std::to_string(lower_bound));
+    {
+        std::lock_guard<std::mutex> lock(cout_mutex);
+        std::cout << line.str() << std::endl;
+    }
+    return {paths_traversed, path, proven};
+}
+
+const size_t SMA_MEMORY_BUDGET_MB = 256; // Default per-level budget of the memory-bounded search
+
+size_t sma_memory_budget = SMA_MEMORY_BUDGET_MB << 20; // Bytes each memory-bounded search may hold; set by "memory=<MB>"
+
+template <typename T>
+class CountingAllocator { // std::allocator that keeps a running total of the bytes it holds
+public:
+    using value_type = T;
+
+    explicit CountingAllocator(size_t* bytes) : bytes(bytes) {}
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>& other) : bytes(other.bytes) {}
+
+    T* allocate(size_t n) {
+        *bytes += n * sizeof(T);
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* pointer, size_t n) {
+        *bytes -= n * sizeof(T);
+        std::allocator<T>().deallocate(pointer, n);
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U>& other) const {
+        return bytes == other.bytes;
+    }
+
+    size_t* bytes;
+};
+
+template <int Words = 0>
+SolveResult solve_game_sma_star(const Board& board, size_t memory_budget = sma_memory_budget, int max_paths = MAX_PATHS_TRAVERSED,
+                                const StopToken* stop = nullptr) {
+    // Simplified memory-bounded A* (SMA*) with duplicate detection. Nodes live in a pool with a free list, and the
+    // state table and open set count the bytes they allocate. Once the total passes memory_budget, the worst
+    // open leaf (highest f-cost, shallowest) is evicted and its f-cost backed up into its parent as the smallest
+    // forgotten f-cost; the parent goes back on the open set under that key and regenerates its missing children
+    // when it comes up again. A node whose children are all pruned is freed at once. Children take at least the
+    // f-cost of the node they came from, so keys never fall below a bound already proven, and the first goal
+    // popped is optimal as long as the budget holds the current path and its siblings.
+    struct Node {
+        PackedState state;
+        uint32_t parent;
+        uint16_t f_cost; // Key the node was created or last reopened under
+        uint16_t forgotten; // Smallest f-cost among evicted children; NO_COST if none
+        uint16_t live_children;
+        uint8_t depth;
+        uint8_t move;
+        bool in_open;
+        bool merged; // Reached at its depth through another parent too, so it is expanded without move pruning
+    };
+    const uint16_t NO_COST = std::numeric_limits<uint16_t>::max();
+    const uint32_t CHUNK_BITS = 12;
+    const uint32_t CHUNK_MASK = (1u << CHUNK_BITS) - 1;
+
+    size_t tracked_bytes = 0; // Held by the table and the open set
+    std::vector<std::unique_ptr<Node[]>> chunks;
+    std::vector<uint32_t> free_nodes;
+    uint32_t pool_size = 0;
+    size_t live_nodes = 0;
+    using OpenKey = std::tuple<int, int, uint32_t>; // f-cost, negated depth, node
+    std::set<OpenKey, std::less<OpenKey>, CountingAllocator<OpenKey>> open(CountingAllocator<OpenKey>{&tracked_bytes});
+    std::set<OpenKey, std::less<OpenKey>, CountingAllocator<OpenKey>> leaves(CountingAllocator<OpenKey>{&tracked_bytes}); // Open nodes with no live children, bar the root
+    using TableEntry = std::pair<const PackedState, uint32_t>;
+    std::unordered_map<PackedState, uint32_t, PackedStateHash, std::equal_to<PackedState>, CountingAllocator<TableEntry>> table(
+        0, PackedStateHash(), std::equal_to<PackedState>(), CountingAllocator<TableEntry>{&tracked_bytes});
+    size_t peak_bytes = 0;
+    long long evictions = 0;
+    int paths_traversed = 0;
+
+    auto node = [&](uint32_t index) -> Node& {
+        return chunks[index >> CHUNK_BITS][index & CHUNK_MASK];
+    };
+    auto memory_in_use = [&]() {
+        return tracked_bytes + live_nodes * sizeof(Node) + free_nodes.capacity() * sizeof(uint32_t);
+    };
+    auto file = [&](uint32_t index, bool filed) { // Add a node to or remove it from the open set, and from leaves if it is one
+        Node& entry = node(index);
+        OpenKey key{entry.f_cost, -entry.depth, index};
+        bool leaf = entry.live_children == 0 && entry.parent != NO_NODE;
+        if (filed) {
+            open.insert(key);
+            if (leaf) {
+                leaves.insert(key);
+            }
+        } else {
+            open.erase(key);
+            if (leaf) {
+                leaves.erase(key);
+            }
+        }
+        entry.in_open = filed;
+    };
+    auto change_children = [&](uint32_t index, int delta) { // Keeps leaves in step as a node gains its first or loses its last child
+        Node& entry = node(index);
+        bool refile = entry.in_open && (entry.live_children == 0 || entry.live_children + delta == 0);
+        if (refile) {
+            file(index, false);
+        }
+        entry.live_children = static_cast<uint16_t>(entry.live_children + delta);
+        if (refile) {
+            file(index, true);
+        }
+    };
+    auto add_node = [&](const PackedState& state, uint32_t parent, uint8_t move, int depth, int f_cost) {
+        uint32_t index;
+        if (!free_nodes.empty()) {
+            index = free_nodes.back();
+            free_nodes.pop_back();
+        } else {
+            if ((pool_size & CHUNK_MASK) == 0) {
+                chunks.emplace_back(new Node[CHUNK_MASK + 1]);
+            }
+            index = pool_size++;
+        }
+        node(index) = {state, parent, static_cast<uint16_t>(f_cost), NO_COST, 0, static_cast<uint8_t>(depth), move, false, false};
+        live_nodes++;
+        table[state] = index;
+        if (parent != NO_NODE) {
+            change_children(parent, 1);
+        }
+        return index;
+    };
+    auto push = [&](uint32_t index, int key) {
+        Node& entry = node(index);
+        if (entry.in_open) {
+            if (key >= entry.f_cost) {
+                return;
+            }
+            file(index, false);
+        }
+        entry.f_cost = static_cast<uint16_t>(key);
+        file(index, true);
+    };
+    auto release = [&](uint32_t index) { // Free a node with no live children; returns its parent
+        Node& entry = node(index);
+        if (entry.in_open) {
+            file(index, false);
+        }
+        auto mapped = table.find(entry.state);
+        if (mapped != table.end() && mapped->second == index) {
+            table.erase(mapped);
+        }
+        uint32_t parent = entry.parent;
+        if (parent != NO_NODE) {
+            change_children(parent, -1);
+        }
+        free_nodes.push_back(index);
+        live_nodes--;
+        return parent;
+    };
+    uint32_t expanding = NO_NODE; // Kept while its successors are being added
+    auto release_dead = [&](uint32_t index) { // Free a childless node that is not waiting to be expanded, and any ancestors left likewise
+        while (index != NO_NODE && index != expanding && node(index).live_children == 0 && !node(index).in_open && node(index).forgotten == NO_COST) {
+            index = release(index);
+        }
+    };
+    auto evict_worst_leaf = [&]() {
+        if (leaves.empty()) {
+            return false;
+        }
+        auto [f_cost, negated_depth, index] = *leaves.rbegin();
+        uint32_t parent = release(index);
+        Node& parent_entry = node(parent);
+        parent_entry.forgotten = std::min<uint16_t>(parent_entry.forgotten, static_cast<uint16_t>(f_cost));
+        push(parent, parent_entry.forgotten);
+        evictions++;
+        return true;
+    };
+    auto report_memory = [&]() {
+        std::ostringstream stats; // Formatted apart from std::cout so the fixed precision does not stick
+        stats << "Level " << board.level << ": SMA* peak memory " << std::fixed << std::setprecision(2) << peak_bytes / (1024.0 * 1024.0)
+              << " MB of " << memory_budget / (1024.0 * 1024.0) << " MB, " << evictions << " nodes evicted";
+        {
+            std::lock_guard<std::mutex> lock(cout_mutex);
+            std::cout << stats.str() << std::endl;
+        }
+        note_table(table.size(), table.bucket_count());
+    };
+
+    int initial_h_cost = combined_heuristic(board, board.initial);
+    if (initial_h_cost >= DEAD_STATE_COST) {
+        return {0, {}};
+    }
+    push(add_node(board.initial, NO_NODE, 0, 0, initial_h_cost), initial_h_cost);
+
+    while (!open.empty() && paths_traversed < max_paths) {
+        auto [key, negated_depth, current_index] = *open.begin();
+        if (key >= incumbent_bound(stop) || key > MAX_PATH_LENGTH) {
+            break; // Nothing left that could beat the shared incumbent or fit the path limit
+        }
+        file(current_index, false);
+        Node& current = node(current_index);
+        current.forgotten = NO_COST; // Regenerated below
+        paths_traversed++;
+        if (should_stop(stop, paths_traversed)) {
+            break;
+        }
+        if (paths_traversed % TABLE_NOTE_INTERVAL == 0) {
+            note_table(table.size(), table.bucket_count());
+        }
+        note_expansion(current.depth);
+
+        if (board.is_goal(current.state)) {
+            MovePath path;
+            for (uint32_t index = current_index; node(index).parent != NO_NODE; index = node(index).parent) {
+                uint8_t move = node(index).move;
+                path.emplace_back(move / NUM_DIRECTIONS, DIRECTIONS[move % NUM_DIRECTIONS].first);
+            }
+            std::reverse(path.begin(), path.end());
+            print_solution(path);
+            report_memory();
+            return {paths_traversed, path};
+        }
+
+        std::array<PackedState, MAX_WORDS * NUM_DIRECTIONS> successors;
+        int successor_count = board.generate_successors<Words>(current.state, successors);
+        uint8_t last_move = NO_MOVE;
+        uint8_t last_from = NO_CELL;
+        if (current.parent != NO_NODE && !current.merged) {
+            last_move = current.move;
+            last_from = node(current.parent).state.cells[current.move / NUM_DIRECTIONS];
+        }
+        uint64_t moves = board.useful_moves<Words>(current.state, successors, last_move, last_from);
+        std::array<int, MAX_WORDS * NUM_DIRECTIONS> h_costs;
+        combined_heuristic_batch<Words>(board, current.state, successors, moves, h_costs);
+        int depth = current.depth + 1;
+        expanding = current_index;
+        for (int move = 0; move < successor_count; ++move) { // Successor order matches the move codes
+            if (!(moves >> move & 1)) {
+                continue;
+            }
+            int f_cost = std::max(depth + h_costs[move], key);
+            if (f_cost >= incumbent_bound(stop) || f_cost > MAX_PATH_LENGTH) {
+                continue;
+            }
+            auto existing = table.find(successors[move]);
+            if (existing != table.end()) {
+                uint32_t existing_index = existing->second;
+                Node& seen = node(existing_index);
+                if (seen.depth < depth) {
+                    note_duplicate();
+                    continue;
+                }
+                if (seen.depth == depth) {
+                    note_duplicate();
+                    if (seen.parent != current_index && !seen.merged) {
+                        seen.merged = true; // Expand it again with every move, which its first parent's pruning may have dropped
+                        push(existing_index, seen.f_cost);
+                    }
+                    continue;
+                }
+                table.erase(existing); // The old copy keeps its subtree but no longer stands for the state
+                if (seen.live_children == 0 && seen.forgotten == NO_COST) {
+                    uint32_t parent = release(existing_index);
+                    release_dead(parent);
+                }
+            }
+            push(add_node(successors[move], current_index, static_cast<uint8_t>(move), depth, f_cost), f_cost);
+        }
+        note_open_size(open.size());
+        expanding = NO_NODE;
+        release_dead(current_index);
+
+        peak_bytes = std::max(peak_bytes, memory_in_use());
+        while (memory_in_use() > memory_budget) {
+            if (!evict_worst_leaf()) {
+                {
+                    std::lock_guard<std::mutex> lock(cout_mutex);
+                    std::cout << "Level " << board.level << ": SMA* cannot fit the current path in " << memory_budget << " bytes" << std::endl;
+                }
+                report_memory();
+                return {paths_traversed, {}};
+            }
+        }
+    }
+
+    report_memory();
+    return {paths_traversed, {}};
+}
+
+std::vector<std::unique_ptr<GameState>> load_level_data(const std::string& csv_file) { // Load level data from a CSV file
+    std::vector<std::unique_ptr<GameState>> levels;
+    std::ifstream file(csv_file);
+    std::string line;
+    std::getline(file, line); // Skip the header line
+
+    while (std::getline(file, line)) {
+        std::istringstream iss(line);
+        std::string level_str, sentence, type, row_str, col_str;
+        std::getline(iss, level_str, ',');
+        std::getline(iss, sentence, ',');
+        std::getline(iss, type, ',');
+        std::getline(iss, row_str, ',');
+        std::getline(iss, col_str, ',');
+
+        int level = std::stoi(level_str);
+        int row = std::stoi(row_str);
+        int col = std::stoi(col_str);
+
+        if (levels.size() < level) { // Ensure the levels vector is large enough
+            levels.emplace_back(std::make_unique<GameState>(level, std::move(sentence), std::vector<Position>(), std::vector<Position>(), Position{8, 8}));
+        }
+
+        if (type.find("Word") != std::string::npos) { // Add word positions
+            levels[level - 1]->word_positions.emplace_back(row, col);
+        } else if (type.find("Wall") != std::string::npos) { // Add wall positions
+            levels[level - 1]->walls.emplace_back(row, col);
+        }
+    }
+
+    return levels;
+}
+
+
+template <int Words = 0>
+SolveResult solve_game_bfs(const Board& board, int max_depth = MAX_PATH_LENGTH, int max_paths = MAX_PATHS_TRAVERSED,
+                           const StopToken* stop = nullptr) {
+    NodeArena arena; // Nodes are appended in BFS order, so the arena doubles as the search queue
+    NodeTable visited(arena);
+
+    visited.insert(arena.add(board.initial, NO_NODE, 0, 0));
+    uint32_t queue_head = 0;
+
+    int paths_traversed = 0;
+
+    while (queue_head < arena.size() && paths_traversed < max_paths && !should_stop(stop, paths_traversed)) {
+        paths_traversed++;
+        uint32_t current_index = queue_head++;
+        const ArenaNode& current = arena[current_index];
+        note_expansion(current.depth);
+        note_open_size(arena.size() - queue_head);
+
+        if (board.is_goal(current.state)) {
+            MovePath path = arena.path_to(current_index);
+            print_solution(path);
+            return {paths_traversed, path};
+        }
+
+        if (current.depth >= max_depth || current.depth + 1 >= incumbent_bound(stop)) {
+            continue;
+        }
+
+        std::array<PackedState, MAX_WORDS * NUM_DIRECTIONS> successors;
+        int successor_count = board.generate_successors<Words>(current.state, successors);
+        auto [last_move, last_from] = arena.last_move(current_index);
+        uint64_t moves = board.useful_moves<Words>(current.state, successors, last_move, last_from);
+        for (int move = 0; move < successor_count; ++move) { // Successor order matches the move codes
+            if (!(moves >> move & 1)) {
+                continue;
+            }
+            if (board.is_dead<Words>(successors[move])) {
+                note_dead_state();
+                continue;
+            }
+            uint32_t existing = visited.find(successors[move]);
+            if (existing == NO_NODE) {
+                visited.insert(arena.add(successors[move], current_index, static_cast<uint8_t>(move), current.depth + 1));
+            } else {
+                note_duplicate();
+                if (arena[existing].depth == current.depth + 1 && arena[existing].parent != current_index) {
+                    arena.mark_merged(existing); // Its pruning would only be valid for the first parent's move
+                }
+            }
+        }
+    }
+
+    return {paths_traversed, {}};
+}
+
+SolveResult solve_game_bidirectional(const Board& board, int max_depth = MAX_PATH_LENGTH, int max_paths = MAX_PATHS_TRAVERSED,
+                                     const StopToken* stop = nullptr) {
+    // Layer-synchronous BFS from the start and, through the reverse move generator, from every goal placement at
+    // once. Each round expands the smaller frontier by one full layer. The first state found on both sides lies
+    // on a shortest path: had a shorter one existed, its midpoint would have been in both visited sets already.
+    struct Side {
+        NodeArena arena;
+        NodeTable visited;
+        uint32_t layer_start = 0;
+        int depth = 0;
+
+        Side() : visited(arena) {}
+    };
+    Side forward;
+    Side backward;
+
+    forward.visited.insert(forward.arena.add(board.initial, NO_NODE, 0, 0));
+    for (const auto& goal : board.goal_states) {
+        if (backward.visited.find(goal) == NO_NODE) {
+            backward.visited.insert(backward.arena.add(goal, NO_NODE, 0, 0));
+        }
+    }
+
+    // Forward moves come from the start node's path; backward nodes store the move that leads to their parent
+    auto join_paths = [&](uint32_t forward_index, uint32_t backward_index) {
+        MovePath path = forward.arena.path_to(forward_index);
+        for (uint32_t current = backward_index; backward.arena[current].parent != NO_NODE; current = backward.arena[current].parent) {
+            uint8_t move = backward.arena[current].move;
+            path.emplace_back(move / NUM_DIRECTIONS, DIRECTIONS[move % NUM_DIRECTIONS].first);
+        }
+        print_solution(path);
+        return path;
+    };
+
+    int paths_traversed = 0;
+    uint32_t start_meet = backward.visited.find(board.initial);
+    if (start_meet != NO_NODE) {
+        return {paths_traversed, join_paths(0, start_meet)};
+    }
+
+    std::array<PackedState, MAX_WORDS * NUM_DIRECTIONS> successors;
+    std::vector<std::pair<PackedState, uint8_t>> neighbors;
+
+    while (forward.layer_start < forward.arena.size() && backward.layer_start < backward.arena.size() &&
+           forward.depth + backward.depth < max_depth && forward.depth + backward.depth + 1 < incumbent_bound(stop) &&
+           paths_traversed < max_paths) {
+        bool expand_forward = forward.arena.size() - forward.layer_start <= backward.arena.size() - backward.layer_start;
+        Side& side = expand_forward ? forward : backward;
+        Side& other = expand_forward ? backward : forward;
+        uint32_t layer_end = side.arena.size();
+        note_open_size(layer_end - side.layer_start);
+
+        for (uint32_t index = side.layer_start; index < layer_end && paths_traversed < max_paths; ++index) {
+            if (should_stop(stop, paths_traversed)) {
+                return {paths_traversed, {}};
+            }
+            paths_traversed++;
+
+            const ArenaNode& node = side.arena[index];
+            note_expansion(node.depth); // Depth from the side's own roots
+            neighbors.clear();
+            if (expand_forward) {
+                int successor_count = board.generate_successors(node.state, successors);
+                for (int move = 0; move < successor_count; ++move) { // Successor order matches the move codes
+                    neighbors.emplace_back(successors[move], static_cast<uint8_t>(move));
+                }
+            } else {
+                board.generate_predecessors(node.state, neighbors);
+            }
+
+            for (const auto& [state, move] : neighbors) {
+                if (side.visited.find(state) != NO_NODE) {
+                    note_duplicate();
+                    continue;
+                }
+                uint32_t child = side.arena.add(state, index, move, side.depth + 1);
+                side.visited.insert(child);
+                uint32_t meet = other.visited.find(state);
+                if (meet != NO_NODE) {
+                    MovePath path = expand_forward ? join_paths(child, meet) : join_paths(meet, child);
+                    return {paths_traversed, path};
+                }
+            }
+        }
+        side.layer_start = layer_end;
+        side.depth++;
     }
 
     return {paths_traversed, {}};
 }
 
-SolveResult solve_level_hybrid(const GameState& level_data) {
-    std::cout << "Starting hybrid solve for Level " << level_data.level << std::endl;
-    
-    // First, try BFS with depth limit 13 (stop before exploring depth 14)
-    auto bfs_result = solve_game_bfs(level_data, 13, MAX_PATHS_TRAVERSED);
-    if (!bfs_result.solution.empty()) {
-        std::cout << "BFS found a solution for Level " << level_data.level << std::endl;
-        return bfs_result;
+SolveResult solve_game_parallel_bfs(const Board& board, int max_depth = MAX_PATH_LENGTH, int max_paths = MAX_PATHS_TRAVERSED,
+                                    int thread_count = std::max(1u, std::thread::hardware_concurrency()),
+                                    const StopToken* stop = nullptr) {
+    // Layer-synchronous BFS: workers claim chunks of the current layer, deduplicate successors through a
+    // sharded visited set and collect new states in per-thread buffers that are joined into the next layer.
+    // When several parents reach a state in the same layer the one whose state orders first wins, so parent
+    // links, and with them the reported solution, do not depend on thread timing.
+    const uint32_t CHUNK_SIZE = 1024;
+    ShardedStateTable visited(10);
+    std::vector<std::vector<PackedState>> layers = {{board.initial}};
+    visited.insert(board.initial, NO_NODE, 0, 0, [](uint32_t, uint8_t, uint32_t, uint8_t) { return false; });
+
+    auto state_order = [](const PackedState& lhs, const PackedState& rhs) {
+        return lhs.hash != rhs.hash ? lhs.hash < rhs.hash : lhs.cells < rhs.cells;
+    };
+
+    auto rebuild_path = [&](const PackedState& goal) {
+        MovePath path;
+        PackedState current = goal;
+        for (int depth = static_cast<int>(layers.size()) - 1; depth > 0; --depth) {
+            ShardedStateTable::Entry entry = visited.find(current);
+            path.emplace_back(entry.move / NUM_DIRECTIONS, DIRECTIONS[entry.move % NUM_DIRECTIONS].first);
+            current = layers[depth - 1][entry.parent];
+        }
+        std::reverse(path.begin(), path.end());
+        print_solution(path);
+        return path;
+    };
+
+    if (board.is_goal(board.initial)) {
+        return {0, rebuild_path(board.initial)};
+    }
+
+    std::atomic<long long> paths_traversed{0};
+    SearchStats* stats = thread_search_stats; // Worker threads count towards the caller's search
+    for (int depth = 0; depth < max_depth && depth + 1 < incumbent_bound(stop) && !layers.back().empty() && paths_traversed < max_paths &&
+         !(stop && stop->stop_requested()); ++depth) {
+        const std::vector<PackedState>& layer = layers.back();
+        note_open_size(layer.size());
+        std::atomic<uint32_t> next_chunk{0};
+        std::vector<std::vector<PackedState>> next_states(thread_count);
+        std::vector<std::vector<PackedState>> goals_found(thread_count);
+
+        // Among parents reaching a state in this layer, prefer the smallest parent state, then move
+        auto prefers = [&](uint32_t parent, uint8_t move, uint32_t current_parent, uint8_t current_move) {
+            if (parent == current_parent) {
+                return move < current_move;
+            }
+            return state_order(layer[parent], layer[current_parent]);
+        };
+
+        auto worker = [&](int thread_index) {
+            std::array<PackedState, MAX_WORDS * NUM_DIRECTIONS> successors;
+            for (uint32_t begin = next_chunk.fetch_add(CHUNK_SIZE); begin < layer.size() && paths_traversed < max_paths &&
+                 !(stop && stop->stop_requested()); begin = next_chunk.fetch_add(CHUNK_SIZE)) {
+                uint32_t end = std::min<uint32_t>(begin + CHUNK_SIZE, layer.size());
+                for (uint32_t index = begin; index < end; ++index) {
+                    note_expansion(depth);
+                    int successor_count = board.generate_successors(layer[index], successors);
+                    for (int move = 0; move < successor_count; ++move) { // Successor order matches the move codes
+                        if (visited.insert(successors[move], index, static_cast<uint8_t>(move), depth + 1, prefers)) {
+                            next_states[thread_index].push_back(successors[move]);
+                            if (board.is_goal(successors[move])) {
+                                goals_found[thread_index].push_back(successors[move]);
+                            }
+                        } else {
+                            note_duplicate();
+                        }
+                    }
+                }
+                paths_traversed += end - begin;
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (int thread_index = 1; thread_index < thread_count; ++thread_index) {
+            workers.emplace_back([&, thread_index]() {
+                StatsScope scope(stats);
+                worker(thread_index);
+            });
+        }
+        worker(0);
+        for (auto& thread : workers) {
+            thread.join();
+        }
+
+        std::vector<PackedState> next_layer;
+        const PackedState* best_goal = nullptr;
+        for (int thread_index = 0; thread_index < thread_count; ++thread_index) {
+            next_layer.insert(next_layer.end(), next_states[thread_index].begin(), next_states[thread_index].end());
+            std::vector<PackedState>().swap(next_states[thread_index]);
+            for (const auto& goal : goals_found[thread_index]) {
+                if (!best_goal || state_order(goal, *best_goal)) {
+                    best_goal = &goal;
+                }
+            }
+        }
+        layers.push_back(std::move(next_layer));
+
+        {
+            std::lock_guard<std::mutex> lock(cout_mutex);
+            std::cout << "Level " << board.level << ": Paths traversed: " << paths_traversed
+                      << " (Using Parallel BFS, " << thread_count << " threads), BFS depth: " << depth + 1
+                      << ", Layer size: " << layers.back().size() << std::endl;
+        }
+
+        if (best_goal) {
+            return {static_cast<int>(paths_traversed), rebuild_path(*best_goal)};
+        }
+    }
+
+    return {static_cast<int>(paths_traversed), {}};
+}
+
+SolveResult solve_game_parallel_astar(const Board& board, int max_paths = MAX_PATHS_TRAVERSED,
+                                      int thread_count = std::max(1u, std::thread::hardware_concurrency()),
+                                      const StopToken* stop = nullptr) {
+    // Hash-distributed A* (HDA*): each state is owned by one thread, chosen by its hash, which keeps the only
+    // open and closed entries for it. Successors are batched to their owner through lock-free inboxes. A
+    // thread with nothing left to expand steals open nodes from others; the owner still deduplicates their
+    // successors. Goals set a shared incumbent, nodes with f >= incumbent are pruned, and the search ends
+    // when every thread is idle with no messages in flight, so the incumbent is optimal.
+    const int THREAD_BITS = 5; // Node references pack the owning thread into the top bits of a uint32_t
+    const int INDEX_BITS = 32 - THREAD_BITS;
+    const size_t BATCH_SIZE = 64;
+    thread_count = std::min(thread_count, 1 << THREAD_BITS);
+
+    struct Message {
+        PackedState state;
+        uint32_t parent;
+        uint8_t move;
+        int g_cost;
+    };
+    struct MessageBatch {
+        std::vector<Message> messages;
+        MessageBatch* next;
+    };
+    struct OpenEntry {
+        int f_cost;
+        int h_cost;
+        int g_cost;
+        uint32_t index;
+        PackedState state; // Copied so thieves never touch the owner's arena
+    };
+    struct CompareEntry {
+        bool operator()(const OpenEntry& lhs, const OpenEntry& rhs) const {
+            return lhs.f_cost != rhs.f_cost ? lhs.f_cost > rhs.f_cost : lhs.h_cost > rhs.h_cost;
+        }
+    };
+    struct Worker {
+        NodeArena arena;
+        NodeTable closed_list;
+        std::priority_queue<OpenEntry, std::vector<OpenEntry>, CompareEntry> open_list;
+        std::mutex open_mutex; // Taken by the owner per pop and by thieves
+        std::atomic<size_t> open_size{0};
+        std::atomic<MessageBatch*> inbox{nullptr};
+
+        Worker() : closed_list(arena) {}
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (int thread_index = 0; thread_index < thread_count; ++thread_index) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+
+    std::atomic<int> incumbent_cost{std::numeric_limits<int>::max()};
+    uint32_t incumbent_node = NO_NODE;
+    std::mutex incumbent_mutex;
+    std::atomic<long long> paths_traversed{0};
+    std::atomic<long long> in_flight{0}; // Messages pushed to an inbox and not yet processed
+    std::atomic<bool> done{false};
+    int idle_count = 0;
+    std::mutex termination_mutex;
+
+    auto owner_of = [&](const PackedState& state) {
+        return static_cast<int>((state.hash >> 32) % thread_count);
+    };
+
+    // Record a state at its owner if it improves on what the owner has seen
+    auto receive = [&](int thread_index, const Message& message) {
+        Worker& worker = *workers[thread_index];
+        uint32_t existing = worker.closed_list.find(message.state);
+        if (existing != NO_NODE && worker.arena[existing].depth <= message.g_cost) {
+            note_duplicate();
+            return;
+        }
+        int h_cost = combined_heuristic(board, message.state);
+        if (message.g_cost + h_cost >= incumbent_cost.load(std::memory_order_relaxed)) {
+            return;
+        }
+        uint32_t index = worker.arena.add(message.state, message.parent, message.move, message.g_cost);
+        worker.closed_list.assign(index);
+        std::lock_guard<std::mutex> lock(worker.open_mutex);
+        worker.open_list.push({message.g_cost + h_cost, h_cost, message.g_cost, index, message.state});
+        worker.open_size.store(worker.open_list.size(), std::memory_order_relaxed);
+    };
+
+    auto run = [&](int thread_index) {
+        Worker& self = *workers[thread_index];
+        std::vector<std::vector<Message>> outgoing(thread_count);
+        std::array<PackedState, MAX_WORDS * NUM_DIRECTIONS> successors;
+
+        auto flush = [&](int target) {
+            if (outgoing[target].empty()) {
+                return;
+            }
+            auto* batch = new MessageBatch{std::move(outgoing[target]), nullptr};
+            outgoing[target].clear();
+            in_flight += batch->messages.size();
+            Worker& receiver = *workers[target];
+            batch->next = receiver.inbox.load(std::memory_order_relaxed);
+            while (!receiver.inbox.compare_exchange_weak(batch->next, batch, std::memory_order_release, std::memory_order_relaxed)) {
+            }
+        };
+
+        auto drain_inbox = [&]() {
+            MessageBatch* batch = self.inbox.exchange(nullptr, std::memory_order_acquire);
+            bool received = batch != nullptr;
+            while (batch) {
+                for (const auto& message : batch->messages) {
+                    receive(thread_index, message);
+                }
+                in_flight -= batch->messages.size();
+                MessageBatch* next = batch->next;
+                delete batch;
+                batch = next;
+            }
+            return received;
+        };
+
+        auto pop = [&](Worker& worker, OpenEntry& entry) { // Best open entry below the incumbent, if any
+            std::lock_guard<std::mutex> lock(worker.open_mutex);
+            while (!worker.open_list.empty()) {
+                entry = worker.open_list.top();
+                worker.open_list.pop();
+                worker.open_size.store(worker.open_list.size(), std::memory_order_relaxed);
+                if (entry.f_cost < incumbent_cost.load(std::memory_order_relaxed) && entry.f_cost < incumbent_bound(stop)) {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        auto expand = [&](const OpenEntry& entry, int owner) {
+            long long expanded = ++paths_traversed;
+            if (expanded >= max_paths || should_stop(stop, expanded)) {
+                done = true;
+            }
+            note_expansion(entry.g_cost);
+            note_open_size(self.open_size.load(std::memory_order_relaxed));
+            uint32_t reference = (static_cast<uint32_t>(owner) << INDEX_BITS) | entry.index;
+            if (board.is_goal(entry.state)) {
+                std::lock_guard<std::mutex> lock(incumbent_mutex);
+                if (entry.g_cost < incumbent_cost) {
+                    incumbent_cost = entry.g_cost;
+                    incumbent_node = reference;
+                }
+                return;
+            }
+            int successor_count = board.generate_successors(entry.state, successors);
+            for (int move = 0; move < successor_count; ++move) { // Successor order matches the move codes
+                if (successors[move] == entry.state) {
+                    continue;
+                }
+                Message message = {successors[move], reference, static_cast<uint8_t>(move), entry.g_cost + 1};
+                int target = owner_of(successors[move]);
+                if (target == thread_index) {
+                    receive(thread_index, message);
+                } else {
+                    outgoing[target].push_back(message);
+                    if (outgoing[target].size() >= BATCH_SIZE) {
+                        flush(target);
+                    }
+                }
+            }
+        };
+
+        auto steal = [&](OpenEntry& entry, int& owner) {
+            for (int offset = 1; offset < thread_count; ++offset) {
+                int victim = (thread_index + offset) % thread_count;
+                if (workers[victim]->open_size.load(std::memory_order_relaxed) > 1 && pop(*workers[victim], entry)) {
+                    owner = victim;
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        while (!done) {
+            drain_inbox();
+
+            OpenEntry entry;
+            int owner = thread_index;
+            if (pop(self, entry)) {
+                if (self.closed_list.find(entry.state) == entry.index) { // Skip entries superseded by a cheaper path
+                    expand(entry, owner);
+                }
+                continue;
+            }
+            if (steal(entry, owner)) {
+                expand(entry, owner);
+                continue;
+            }
+
+            bool flushed = false;
+            for (int target = 0; target < thread_count; ++target) {
+                flushed |= !outgoing[target].empty();
+                flush(target);
+            }
+            if (flushed) {
+                continue;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(termination_mutex);
+                if (++idle_count == thread_count && in_flight == 0) {
+                    done = true;
+                }
+            }
+            while (!done && !self.inbox.load(std::memory_order_acquire)) {
+                bool stealable = false;
+                for (int victim = 0; victim < thread_count && !stealable; ++victim) {
+                    stealable = victim != thread_index && workers[victim]->open_size.load(std::memory_order_relaxed) > 1;
+                }
+                if (stealable) {
+                    break;
+                }
+                std::this_thread::yield();
+            }
+            std::lock_guard<std::mutex> lock(termination_mutex);
+            if (!done) {
+                idle_count--;
+            }
+        }
+    };
+
+    Message root = {board.initial, NO_NODE, 0, 0};
+    receive(owner_of(board.initial), root);
+
+    SearchStats* stats = thread_search_stats; // Worker threads count towards the caller's search
+    std::vector<std::thread> threads;
+    for (int thread_index = 1; thread_index < thread_count; ++thread_index) {
+        threads.emplace_back([&, thread_index]() {
+            StatsScope scope(stats);
+            run(thread_index);
+        });
+    }
+    run(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (auto& worker : workers) { // Batches left behind when the node budget ran out
+        MessageBatch* batch = worker->inbox.exchange(nullptr);
+        while (batch) {
+            MessageBatch* next = batch->next;
+            delete batch;
+            batch = next;
+        }
+    }
+
+    if (incumbent_node == NO_NODE) {
+        return {static_cast<int>(paths_traversed), {}};
+    }
+    MovePath path;
+    for (uint32_t reference = incumbent_node; reference != NO_NODE;) {
+        const ArenaNode& node = workers[reference >> INDEX_BITS]->arena[reference & ((1u << INDEX_BITS) - 1)];
+        if (node.parent != NO_NODE) {
+            path.emplace_back(node.move / NUM_DIRECTIONS, DIRECTIONS[node.move % NUM_DIRECTIONS].first);
+        }
+        reference = node.parent;
+    }
+    std::reverse(path.begin(), path.end());
+    print_solution(path);
+    return {static_cast<int>(paths_traversed), path};
+}
+
+const size_t DDD_BUFFER_STATES = 1 << 22; // Successors sorted in memory before a run file is spilled (96 MB of PackedState)
+const char* const DDD_DIRECTORY = "ddd"; // Scratch space for external-memory BFS layers, relative to the working directory
+
+class StateRecordWriter { // Appends packed states to a file as num_words cell bytes each
+public:
+    StateRecordWriter(const std::string& path, int record_size)
+        : file(std::fopen(path.c_str(), "wb")), record_size(record_size), buffer(1 << 20) {
+        if (!file) {
+            throw std::runtime_error("Cannot write " + path);
+        }
+        std::setvbuf(file, buffer.data(), _IOFBF, buffer.size());
+    }
+
+    ~StateRecordWriter() {
+        std::fclose(file);
+    }
+
+    void write(const PackedState& state) {
+        std::fwrite(state.cells.data(), 1, record_size, file);
+        count++;
+    }
+
+    size_t count = 0;
+
+private:
+    std::FILE* file;
+    int record_size;
+    std::vector<char> buffer;
+};
+
+class StateRecordReader { // Streams packed states back from a StateRecordWriter file
+public:
+    StateRecordReader(const std::string& path, const Board& board)
+        : file(std::fopen(path.c_str(), "rb")), board(board), buffer(1 << 20) {
+        if (!file) {
+            throw std::runtime_error("Cannot read " + path);
+        }
+        std::setvbuf(file, buffer.data(), _IOFBF, buffer.size());
+    }
+
+    ~StateRecordReader() {
+        std::fclose(file);
+    }
+
+    bool next(PackedState& state) {
+        std::array<uint8_t, MAX_WORDS> cells;
+        if (std::fread(cells.data(), 1, board.num_words, file) != static_cast<size_t>(board.num_words)) {
+            return false;
+        }
+        state = board.pack_cells(cells.data());
+        return true;
+    }
+
+private:
+    std::FILE* file;
+    const Board& board;
+    std::vector<char> buffer;
+};
+
+SolveResult solve_game_external_bfs(const Board& board, int max_depth = MAX_PATH_LENGTH, int max_paths = MAX_PATHS_TRAVERSED,
+                                    const StopToken* stop = nullptr) {
+    // BFS with delayed duplicate detection. Every layer lives on disk sorted by cells. Successors of a layer are
+    // collected in a bounded buffer, sorted and spilled as run files; the runs are then merged and, in the same
+    // pass, subtracted against the earlier layers. Slides are not reversible, so a state can reappear far more
+    // than two layers after it was first seen; merging against every earlier layer keeps each state in exactly
+    // one layer. The path is rebuilt afterwards by scanning the layer files backwards for a parent of each step.
+    namespace fs = std::filesystem;
+    fs::path directory = fs::path(DDD_DIRECTORY) / ("level" + std::to_string(board.level) + "_" + std::to_string(getpid()));
+    fs::create_directories(directory);
+    auto layer_path = [&](int depth) {
+        return (directory / ("layer" + std::to_string(depth) + ".bin")).string();
+    };
+    auto run_path = [&](int run) {
+        return (directory / ("run" + std::to_string(run) + ".bin")).string();
+    };
+    auto by_cells = [](const PackedState& lhs, const PackedState& rhs) {
+        return lhs.cells < rhs.cells;
+    };
+
+    {
+        StateRecordWriter writer(layer_path(0), board.num_words);
+        writer.write(board.initial);
+    }
+
+    long long paths_traversed = 0;
+    int goal_depth = board.is_goal(board.initial) ? 0 : -1;
+    PackedState goal = board.initial;
+    std::vector<PackedState> buffer; // Grows with the layers, so small levels never hold the whole DDD_BUFFER_STATES
+
+    for (int depth = 0; goal_depth < 0 && depth < max_depth && depth + 1 < incumbent_bound(stop) && paths_traversed < max_paths &&
+         !(stop && stop->stop_requested()); ++depth) {
+        // Expand the layer into sorted, locally unique run files
+        int run_count = 0;
+        auto spill = [&]() {
+            std::sort(buffer.begin(), buffer.end(), by_cells);
+            auto unique_end = std::unique(buffer.begin(), buffer.end());
+            add_count(stats_block().duplicates, buffer.end() - unique_end);
+            buffer.erase(unique_end, buffer.end());
+            StateRecordWriter writer(run_path(run_count++), board.num_words);
+            for (const auto& state : buffer) {
+                writer.write(state);
+            }
+            buffer.clear();
+        };
+        {
+            StateRecordReader layer(layer_path(depth), board);
+            std::array<PackedState, MAX_WORDS * NUM_DIRECTIONS> successors;
+            PackedState state;
+            while (!should_stop(stop, paths_traversed) && layer.next(state)) { // A cut-short layer is still exact
+                paths_traversed++;
+                note_expansion(depth);
+                int successor_count = board.generate_successors(state, successors);
+                for (int move = 0; move < successor_count; ++move) {
+                    if (successors[move] != state) {
+                        buffer.push_back(successors[move]);
+                    }
+                }
+                if (buffer.size() + MAX_WORDS * NUM_DIRECTIONS > DDD_BUFFER_STATES) {
+                    spill();
+                }
+            }
+        }
+        if (!buffer.empty() || run_count == 0) {
+            spill();
+        }
+
+        // Merge the runs, dropping states already in an earlier layer
+        std::vector<std::unique_ptr<StateRecordReader>> runs;
+        using HeapEntry = std::pair<PackedState, int>;
+        auto heap_order = [&](const HeapEntry& lhs, const HeapEntry& rhs) {
+            return by_cells(rhs.first, lhs.first);
+        };
+        std::priority_queue<HeapEntry, std::vector<HeapEntry>, decltype(heap_order)> heap(heap_order);
+        for (int run = 0; run < run_count; ++run) {
+            runs.push_back(std::make_unique<StateRecordReader>(run_path(run), board));
+            PackedState state;
+            if (runs.back()->next(state)) {
+                heap.push({state, run});
+            }
+        }
+        struct EarlierLayer {
+            std::unique_ptr<StateRecordReader> reader;
+            PackedState current;
+            bool valid;
+        };
+        std::vector<EarlierLayer> earlier;
+        for (int previous = 0; previous <= depth; ++previous) {
+            EarlierLayer layer{std::make_unique<StateRecordReader>(layer_path(previous), board), {}, false};
+            layer.valid = layer.reader->next(layer.current);
+            earlier.push_back(std::move(layer));
+        }
+
+        size_t layer_size = 0;
+        {
+            StateRecordWriter writer(layer_path(depth + 1), board.num_words);
+            bool has_last = false;
+            PackedState last;
+            while (!heap.empty()) {
+                auto [state, run] = heap.top();
+                heap.pop();
+                PackedState next_state;
+                if (runs[run]->next(next_state)) {
+                    heap.push({next_state, run});
+                }
+                if (has_last && last == state) {
+                    note_duplicate();
+                    continue;
+                }
+                has_last = true;
+                last = state;
+
+                bool seen = false;
+                for (auto& layer : earlier) {
+                    while (layer.valid && by_cells(layer.current, state)) {
+                        layer.valid = layer.reader->next(layer.current);
+                    }
+                    seen |= layer.valid && layer.current == state;
+                }
+                if (seen) {
+                    note_duplicate();
+                    continue;
+                }
+                writer.write(state);
+                if (goal_depth < 0 && board.is_goal(state)) {
+                    goal_depth = depth + 1;
+                    goal = state;
+                }
+            }
+            layer_size = writer.count;
+        }
+        note_open_size(layer_size);
+        runs.clear();
+        for (int run = 0; run < run_count; ++run) {
+            fs::remove(run_path(run));
+        }
+
+        std::lock_guard<std::mutex> lock(cout_mutex);
+        std::cout << "Level " << board.level << ": Paths traversed: " << paths_traversed
+                  << " (Using External BFS), BFS depth: " << depth + 1 << ", Layer size: " << layer_size << std::endl;
+        if (layer_size == 0) {
+            break;
+        }
+    }
+
+    MovePath path;
+    if (goal_depth > 0) {
+        PackedState target = goal;
+        std::array<PackedState, MAX_WORDS * NUM_DIRECTIONS> successors;
+        for (int depth = goal_depth - 1; depth >= 0; --depth) {
+            StateRecordReader layer(layer_path(depth), board);
+            PackedState state;
+            bool found = false;
+            while (!found && layer.next(state)) {
+                int successor_count = board.generate_successors(state, successors);
+                for (int move = 0; move < successor_count && !found; ++move) {
+                    if (successors[move] == target) {
+                        path.emplace_back(move / NUM_DIRECTIONS, DIRECTIONS[move % NUM_DIRECTIONS].first);
+                        target = state;
+                        found = true;
+                    }
+                }
+            }
+        }
+        std::reverse(path.begin(), path.end());
+        print_solution(path);
+    }
+
+    std::error_code error;
+    fs::remove_all(directory, error);
+    return {static_cast<int>(paths_traversed), path};
+}
+
+const char* const SOLUTION_CACHE_DIRECTORY = "solutions"; // Where solved layouts are remembered, relative to the working directory
+
+bool use_solution_cache = true; // Cleared by the "c" flag to re-solve every level from scratch
+
+// Solutions persisted per layout. The key is the grid size, walls, initial word positions and word count, which
+// is everything a solution depends on. The eight mirror and rotation images of a layout share one entry: the key
+// is taken in whichever orientation serializes smallest and moves are stored in that orientation, then mapped
+// back on lookup. Each entry is a small text file named by the key's FNV-1a hash and holding the full key, so a
+// hash collision reads as a miss. Hits are replayed with Board::move_word before they are trusted.
+class SolutionCache {
+public:
+    struct Entry {
+        std::string algorithm;
+        bool optimal; // Found by a search that guarantees the shortest solution
+        long long nodes;
+        MovePath solution;
+    };
+
+    static bool lookup(const Board& board, Entry& entry) {
+        Layout layout(board);
+        std::ifstream file(layout.path());
+        std::string line, key, algorithm;
+        if (!std::getline(file, key) || key != "key " + layout.key || !std::getline(file, line) || line.rfind("algorithm ", 0) != 0) {
+            return false;
+        }
+        entry.algorithm = line.substr(10);
+        int optimal = 0;
+        int move_count = 0;
+        std::string label;
+        if (!(file >> label >> optimal) || label != "optimal" || !(file >> label >> entry.nodes) || label != "nodes" ||
+            !(file >> label >> move_count) || label != "moves") {
+            return false;
+        }
+        entry.optimal = optimal != 0;
+        entry.solution.clear();
+        PackedState state = board.initial;
+        for (int i = 0; i < move_count; ++i) {
+            int word_index, canonical_dir;
+            if (!(file >> word_index >> canonical_dir) || word_index < 0 || word_index >= board.num_words ||
+                canonical_dir < 0 || canonical_dir >= NUM_DIRECTIONS) {
+                return false;
+            }
+            int dir = layout.from_canonical(canonical_dir);
+            board.move_word(state, word_index, dir);
+            entry.solution.emplace_back(word_index, DIRECTIONS[dir].first);
+        }
+        return board.is_goal(state); // A stale or corrupt entry is treated as a miss
+    }
+
+    // Record a solution unless the cache already holds one at least as good
+    static void store(const Board& board, const Entry& entry) {
+        if (entry.solution.empty()) {
+            return;
+        }
+        Entry existing;
+        if (lookup(board, existing) && (existing.optimal || !entry.optimal) && existing.solution.size() <= entry.solution.size()) {
+            return;
+        }
+        Layout layout(board);
+        std::error_code error;
+        std::filesystem::create_directories(SOLUTION_CACHE_DIRECTORY, error);
+        static std::atomic<int> temp_counter{0}; // Levels are solved concurrently within one process
+        std::string path = layout.path();
+        std::string temp_path = path + "." + std::to_string(getpid()) + "_" + std::to_string(temp_counter++) + ".tmp";
+        {
+            std::ofstream file(temp_path);
+            file << "key " << layout.key << "\nalgorithm " << entry.algorithm << "\noptimal " << (entry.optimal ? 1 : 0)
+                 << "\nnodes " << entry.nodes << "\nmoves " << entry.solution.size() << "\n";
+            for (const auto& move : entry.solution) {
+                int dir = 0;
+                while (DIRECTIONS[dir].first != move.second) {
+                    dir++;
+                }
+                file << move.first << " " << layout.to_canonical(dir) << "\n";
+            }
+            if (!file) {
+                std::filesystem::remove(temp_path, error);
+                return;
+            }
+        }
+        std::filesystem::rename(temp_path, path, error);
+    }
+
+private:
+    // The layout seen through the symmetry whose key serializes smallest
+    struct Layout {
+        std::string key;
+        int symmetry = 0;
+
+        explicit Layout(const Board& board) {
+            for (int candidate = 0; candidate < 8; ++candidate) {
+                std::string candidate_key = serialize(board, candidate);
+                if (candidate == 0 || candidate_key < key) {
+                    key = std::move(candidate_key);
+                    symmetry = candidate;
+                }
+            }
+        }
+
+        std::string path() const {
+            uint64_t hash = 14695981039346656037ULL; // FNV-1a
+            for (char c : key) {
+                hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ULL;
+            }
+            std::ostringstream oss;
+            oss << SOLUTION_CACHE_DIRECTORY << "/" << std::hex << std::setw(16) << std::setfill('0') << hash << ".sol";
+            return oss.str();
+        }
+
+        int to_canonical(int dir) const {
+            Position moved = transform_vector(symmetry, DIRECTIONS[dir].second);
+            for (int canonical_dir = 0; canonical_dir < NUM_DIRECTIONS; ++canonical_dir) {
+                if (DIRECTIONS[canonical_dir].second == moved) {
+                    return canonical_dir;
+                }
+            }
+            return dir;
+        }
+
+        int from_canonical(int canonical_dir) const {
+            for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                if (to_canonical(dir) == canonical_dir) {
+                    return dir;
+                }
+            }
+            return canonical_dir;
+        }
+
+        // Symmetries 0-3 are identity, left-right mirror, up-down mirror and half turn; 4-7 are the same
+        // composed with a transpose, which swaps the grid's rows and columns.
+        static Position transform_vector(int symmetry, const Position& vector) {
+            int row = vector.first;
+            int col = vector.second;
+            if (symmetry & 4) {
+                std::swap(row, col);
+            }
+            return {(symmetry & 2) ? -row : row, (symmetry & 1) ? -col : col};
+        }
+
+        static std::string serialize(const Board& board, int symmetry) {
+            int rows = (symmetry & 4) ? board.cols : board.rows;
+            int cols = (symmetry & 4) ? board.rows : board.cols;
+            auto transform_cell = [&](const Position& pos) {
+                int row = pos.first;
+                int col = pos.second;
+                if (symmetry & 4) {
+                    std::swap(row, col);
+                }
+                if (symmetry & 2) {
+                    row = rows - 1 - row;
+                }
+                if (symmetry & 1) {
+                    col = cols - 1 - col;
+                }
+                return row * cols + col;
+            };
+            std::vector<int> walls;
+            for (const auto& wall : board.walls) {
+                walls.push_back(transform_cell(wall));
+            }
+            std::sort(walls.begin(), walls.end());
+            walls.erase(std::unique(walls.begin(), walls.end()), walls.end());
+            std::ostringstream oss;
+            oss << std::setfill('0') << std::setw(3) << rows << "x" << std::setw(3) << cols << " words";
+            for (int i = 0; i < board.num_words; ++i) {
+                oss << " " << std::setw(3) << transform_cell(board.position(board.initial.cells[i]));
+            }
+            oss << " walls";
+            for (int wall : walls) {
+                oss << " " << std::setw(3) << wall;
+            }
+            return oss.str();
+        }
+    };
+};
+
+bool proves_optimality(int algorithm_choice) { // Whether a solution from this solver is known to be shortest
+    // Beam search, the hybrid, ARA* and the portfolio may not; the anytime ones say so in SolveResult::proven_optimal
+    return algorithm_choice != 2 && algorithm_choice != 3 && algorithm_choice != 9 && algorithm_choice != 10;
+}
+
+// Call solve.template operator()<Words>() with the board's word count when the BFS, A* and IDA* solvers have an
+// instantiation for it (the 4 to 9 words of the shipped levels), and with Words = 0, read at run time, otherwise
+template <typename Solve>
+SolveResult with_word_count(const Board& board, Solve&& solve) {
+    switch (board.num_words) {
+        case 4: return solve.template operator()<4>();
+        case 5: return solve.template operator()<5>();
+        case 6: return solve.template operator()<6>();
+        case 7: return solve.template operator()<7>();
+        case 8: return solve.template operator()<8>();
+        case 9: return solve.template operator()<9>();
+        default: return solve.template operator()<0>();
+    }
+}
+
+SolveResult solve_level_hybrid(const Board& level_data, const StopToken* stop = nullptr) {
+    SolutionCache::Entry cached;
+    if (use_solution_cache && SolutionCache::lookup(level_data, cached)) { // Any verified entry is as good as a hybrid result
+        {
+            std::lock_guard<std::mutex> lock(cout_mutex);
+            std::cout << "Cached solution for Level " << level_data.level << " (" << cached.algorithm << ")" << std::endl;
+        }
+        return {0, cached.solution};
+    }
+    auto remember = [&](const SolveResult& result, const char* algorithm, bool optimal, int paths_traversed) {
+        if (use_solution_cache) {
+            SolutionCache::store(level_data, {algorithm, optimal, paths_traversed, result.solution});
+        }
+        return result;
+    };
+
+    std::cout << "Starting hybrid solve for Level " << level_data.level << std::endl;
+    
+    // First, try BFS with depth limit 13 (stop before exploring depth 14)
+    auto bfs_result = with_word_count(level_data, [&]<int Words>() { return solve_game_bfs<Words>(level_data, 13, MAX_PATHS_TRAVERSED, stop); });
+    if (!bfs_result.solution.empty()) {
+        std::cout << "BFS found a solution for Level " << level_data.level << std::endl;
+        return remember(bfs_result, "BFS", true, bfs_result.paths_traversed);
+    }
+    
+    // If BFS fails, try A* with 1M paths limit
+    std::cout << "BFS failed, trying A* for Level " << level_data.level << std::endl;
+    auto astar_result = with_word_count(level_data, [&]<int Words>() { return solve_game_astar<Words>(level_data, 1000000, stop); });
+    
+    // Always try IDA* with 1M paths limit
+    std::cout << "Trying IDA* for Level " << level_data.level << std::endl;
+    auto ida_result = solve_game_ida_star_beam(level_data, 1000000, stop);
+    
+    if (!astar_result.solution.empty() && !ida_result.solution.empty()) {
+        std::cout << "Both A* and IDA* found solutions for Level " << level_data.level << std::endl;
+        size_t shorter_length = std::min(astar_result.solution.size(), ida_result.solution.size());
+        std::cout << "Length of shorter solution: " << shorter_length << std::endl;
+        int paths_traversed = bfs_result.paths_traversed + astar_result.paths_traversed + ida_result.paths_traversed;
+        if (astar_result.solution.size() <= ida_result.solution.size()) {
+            std::cout << "A* solution is shorter or equal. Using A* solution." << std::endl;
+            return remember(astar_result, "A*", true, paths_traversed);
+        } else { // Cannot happen while the heuristic is admissible, but the beam result is not proven shortest
+            std::cout << "IDA* solution is shorter. Using IDA* solution." << std::endl;
+            return remember(ida_result, "IDA* with Beam Search", false, paths_traversed);
+        }
+    } else if (!astar_result.solution.empty()) {
+        std::cout << "Only A* found a solution for Level " << level_data.level << std::endl;
+        return remember(astar_result, "A*", true, bfs_result.paths_traversed + astar_result.paths_traversed + ida_result.paths_traversed);
+    } else if (!ida_result.solution.empty()) {
+        std::cout << "Only IDA* found a solution for Level " << level_data.level << std::endl;
+        return remember(ida_result, "IDA* with Beam Search", false,
+                        bfs_result.paths_traversed + astar_result.paths_traversed + ida_result.paths_traversed);
+    }
+    
+    std::cout << "All algorithms failed to find a solution for Level " << level_data.level << std::endl;
+    return {ida_result.paths_traversed + astar_result.paths_traversed + bfs_result.paths_traversed, {}};
+}
+
+const char* algorithm_name(int algorithm_choice) {
+    switch (algorithm_choice) {
+        case 0: return "BFS";
+        case 1: return "A*";
+        case 2: return "IDA* with Beam Search";
+        case 3: return "Hybrid";
+        case 4: return "IDA*";
+        case 5: return "Bidirectional BFS";
+        case 6: return "Parallel BFS";
+        case 7: return "Parallel A* (HDA*)";
+        case 8: return "External BFS";
+        case 9: return "ARA*";
+        case 10: return "Portfolio";
+        case 11: return "SMA*";
+        default: return "Unknown";
+    }
+}
+
+bool uses_heuristics(int algorithm_choice) { // The BFS solvers never consult the pattern database
+    return algorithm_choice != 0 && algorithm_choice != 5 && algorithm_choice != 6 && algorithm_choice != 8;
+}
+
+SolveResult solve_game_portfolio(const Board& board, int max_paths = 0, const StopToken* stop = nullptr);
+
+// Run one solver by its algorithm_name index; budgets of zero keep each solver's own default limit. The search's
+// statistics are open to the reporter thread while it runs and come back in the result.
+SolveResult run_solver(const Board& board, int algorithm_choice, int max_paths = 0, const StopToken* stop = nullptr) {
+    int node_budget = max_paths > 0 ? max_paths : MAX_PATHS_TRAVERSED;
+    unsigned thread_count = solver_thread_count ? solver_thread_count : std::max(1u, std::thread::hardware_concurrency());
+    SearchStats stats(board.level, algorithm_name(algorithm_choice));
+    SolveResult result{0, {}};
+    {
+        StatsScope scope(&stats);
+        switch (algorithm_choice) {
+            case 0:
+                result = with_word_count(board, [&]<int Words>() { return solve_game_bfs<Words>(board, MAX_PATH_LENGTH, node_budget, stop); });
+                break;
+            case 1:
+                result = with_word_count(board, [&]<int Words>() { return solve_game_astar<Words>(board, node_budget, stop); });
+                break;
+            case 2: result = solve_game_ida_star_beam(board, node_budget, stop); break;
+            case 4:
+                result = with_word_count(board, [&]<int Words>() { return solve_game_ida_star<Words>(board, node_budget, stop); });
+                break;
+            case 5: result = solve_game_bidirectional(board, MAX_PATH_LENGTH, node_budget, stop); break;
+            case 6: result = solve_game_parallel_bfs(board, MAX_PATH_LENGTH, node_budget, thread_count, stop); break;
+            case 7: result = solve_game_parallel_astar(board, node_budget, thread_count, stop); break;
+            case 8: result = solve_game_external_bfs(board, MAX_PATH_LENGTH, node_budget, stop); break;
+            case 9: result = solve_game_ara_star(board, ARA_TIME_BUDGET_SECONDS, node_budget, stop); break;
+            case 10: result = solve_game_portfolio(board, max_paths, stop); break; // Carries its racers' statistics
+            case 11:
+                result = with_word_count(board, [&]<int Words>() { return solve_game_sma_star<Words>(board, sma_memory_budget, node_budget, stop); });
+                break;
+            default: result = solve_level_hybrid(board, stop); break;
+        }
+    }
+    result.stats.merge(stats.snapshot());
+    return result;
+}
+
+const std::array<int, 5> PORTFOLIO_SOLVERS = {0, 1, 2, 4, 9}; // algorithm_name indices raced by the portfolio
+const double PORTFOLIO_TIME_BUDGET_SECONDS = 60; // Wall-clock budget of the whole race
+
+SolveResult solve_game_portfolio(const Board& board, int max_paths, const StopToken* stop) {
+    // Race single-threaded solvers on the same board, one thread each. They share a token whose incumbent is
+    // the shortest solution any of them has found, and each prunes nodes whose f-cost reaches it. The race is
+    // over once the incumbent is proven shortest: an optimal solver returns a solution, ARA* finishes its last
+    // pass, or an optimal solver exhausts its search without beating the incumbent. The budget or the caller's
+    // token also ends it, with whatever the incumbent is then.
+    auto start_time = std::chrono::steady_clock::now();
+    StopToken race(stop);
+    race.set_deadline(start_time + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                       std::chrono::duration<double>(PORTFOLIO_TIME_BUDGET_SECONDS)));
+    int node_budget = max_paths > 0 ? max_paths : MAX_PATHS_TRAVERSED;
+
+    std::mutex best_mutex;
+    SolveResult best = {0, {}};
+    int winner = -1;
+    double time_to_best = 0;
+    std::vector<std::thread> threads;
+    for (int choice : PORTFOLIO_SOLVERS) {
+        threads.emplace_back([&, choice]() {
+            SolveResult result = run_solver(board, choice, max_paths, &race);
+            bool exhausted = result.solution.empty() && proves_optimality(choice) && result.paths_traversed < node_budget &&
+                             !race.stop_requested();
+            std::lock_guard<std::mutex> lock(best_mutex);
+            best.paths_traversed += result.paths_traversed;
+            best.stats.merge(result.stats);
+            if (!result.solution.empty() && (best.solution.empty() || result.solution.size() < best.solution.size())) {
+                race.offer_incumbent(static_cast<int>(result.solution.size()));
+                best.solution = result.solution;
+                best.proven_optimal = false;
+                winner = choice;
+                time_to_best = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+            }
+            bool proven = !result.solution.empty() && (proves_optimality(choice) || result.proven_optimal) &&
+                          result.solution.size() == best.solution.size();
+            if (proven || (exhausted && !best.solution.empty())) {
+                best.proven_optimal = true;
+                race.cancel();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::lock_guard<std::mutex> lock(cout_mutex);
+    if (winner >= 0) {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(3) << time_to_best;
+        std::cout << "Level " << board.level << ": Portfolio best from " << algorithm_name(winner) << ", length "
+                  << best.solution.size() << (best.proven_optimal ? " (optimal)" : " (not proven optimal)")
+                  << " after " << oss.str() << " s" << std::endl;
+    } else {
+        std::cout << "Level " << board.level << ": Portfolio found no solution" << std::endl;
+    }
+    return best;
+}
+
+// How a run_solver call ended: solved, exhausted (no solution within the search's own limits), node_budget,
+// timeout or cancelled
+const char* solve_status(const SolveResult& result, const StopToken& stop, int node_budget) {
+    if (!result.solution.empty()) {
+        return "solved";
+    } else if (stop.is_cancelled()) {
+        return "cancelled";
+    } else if (stop.deadline_passed()) {
+        return "timeout";
+    } else if (node_budget > 0 && result.paths_traversed >= node_budget) {
+        return "node_budget";
+    }
+    return "exhausted";
+}
+
+void solve_level(const GameState& level_data, int algorithm_choice) {
+    Board board(level_data);
+    SolutionCache::Entry cached;
+    // The hybrid consults the cache itself; other solvers take a hit if it is optimal or they would not prove it anyway
+    if (use_solution_cache && algorithm_choice != 3 && SolutionCache::lookup(board, cached) &&
+        (cached.optimal || !proves_optimality(algorithm_choice))) {
+        std::lock_guard<std::mutex> lock(cout_mutex);
+        std::cout << "Solution for Level " << level_data.level << " (cached, found by " << cached.algorithm << "): ";
+        for (const auto& move : cached.solution) {
+            std::cout << "(" << level_data.words[move.first] << ", " << move.second << ") ";
+        }
+        std::cout << std::endl;
+        std::cout << "Minimum moves for Level " << level_data.level << ": " << cached.solution.size()
+                  << (cached.optimal ? "" : " (not proven optimal)") << std::endl;
+        std::cout << "Paths traversed for Level " << level_data.level << ": 0 (" << cached.nodes << " when first solved)" << std::endl;
+        std::cout << std::endl;
+        return;
+    }
+    if (uses_heuristics(algorithm_choice)) {
+        board.pattern_database = PatternDatabase::load_or_build(board);
+    }
+    int possible_positions = board.possible_positions;
+    {
+        std::lock_guard<std::mutex> lock(cout_mutex);
+        std::cout << "Solving Level " << level_data.level << std::endl;
+        std::cout << "Possible positions for sentence: " << possible_positions << " (" << board.goal_states.size()
+                  << " reachable)" << std::endl;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    SolveResult result = run_solver(board, algorithm_choice);
+    
+    auto solution = result.solution;
+    auto paths_traversed = result.paths_traversed;
+    auto end = std::chrono::high_resolution_clock::now();
+    if (use_solution_cache && algorithm_choice != 3) {
+        bool optimal = proves_optimality(algorithm_choice) || result.proven_optimal;
+        SolutionCache::store(board, {algorithm_name(algorithm_choice), optimal, paths_traversed, solution});
+    }
+    std::chrono::duration<double> time_taken = end - start;
+
+    std::lock_guard<std::mutex> lock(cout_mutex);
+    if (!solution.empty()) {
+        std::cout << "Solution for Level " << level_data.level << " (" 
+                  << algorithm_name(algorithm_choice) << "): ";
+        for (const auto& move : solution) {
+            std::cout << "(" << level_data.words[move.first] << ", " << move.second << ") ";
+        }
+        std::cout << std::endl;
+        std::cout << "Minimum moves for Level " << level_data.level << ": " << solution.size() << std::endl;
+        std::cout << "Time taken for Level " << level_data.level << ": " << time_taken.count() << " seconds" << std::endl;
+        std::cout << "Paths traversed for Level " << level_data.level << ": " << paths_traversed << std::endl;
+    } else {
+        std::cout << "No solution found for Level " << level_data.level << " (" 
+                  << algorithm_name(algorithm_choice) << ")" << std::endl;
+        std::cout << "Paths traversed for Level " << level_data.level << ": " << paths_traversed << std::endl;
+    }
+    std::cout << "Search stats for Level " << level_data.level << ": " << result.stats.to_json(true) << std::endl;
+    std::cout << std::endl;
+}
+
+// ---------------------------------------------------------------------------------------------------------------
+// Server mode: JSON-lines requests on stdin ("serve") or a Unix domain socket ("serve=<path>"). Each line is one
+// object. A solve request carries a level and optional budgets:
+//   {"id": 1, "rows": 8, "cols": 8, "sentence": "The quick brown fox", "words": [[0, 0], [2, 3], [4, 1], [7, 7]],
+//    "walls": [[3, 3]], "algorithm": "d", "max_nodes": 1000000, "max_seconds": 2.5}
+// "algorithm" takes the command-line letters (omitted means BFS). {"op": "cancel", "id": 1} stops a queued or
+// running request. One result line per solve is written as it finishes, in completion order:
+//   {"id": 1, "status": "solved", "algorithm": "IDA*", "length": 11, "moves": [["The", "right"], ...],
+//    "optimal": true, "nodes": 959, "queue_seconds": 0, "setup_seconds": 0.01, "solve_seconds": 0.02, "board_cached": true,
+//    "stats": {"expanded": 959, ...}}
+// Status is one of solved, exhausted (no solution within the search's own limits), node_budget, timeout,
+// cancelled or error; a request with a field of the wrong type or out of range, such as a fractional or off-grid
+// position, gets an error line. "stats" is SearchStatsSnapshot::to_json. Boards, with their slide tables and
+// pattern databases, are cached across requests.
+// ---------------------------------------------------------------------------------------------------------------
+
+struct JsonValue { // Parsed JSON value; objects keep their members in document order
+    enum class Type { Null, Bool, Number, String, Array, Object };
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0;
+    std::string text;
+    std::vector<JsonValue> items;
+    std::vector<std::pair<std::string, JsonValue>> members;
+
+    const JsonValue* get(const std::string& key) const { // Member of an object, or nullptr
+        for (const auto& member : members) {
+            if (member.first == key) {
+                return &member.second;
+            }
+        }
+        return nullptr;
+    }
+};
+
+class JsonParser { // Recursive-descent parser for one JSON document; throws std::invalid_argument on bad input
+public:
+    explicit JsonParser(const std::string& input) : input(input) {}
+
+    JsonValue parse() {
+        JsonValue value = parse_value();
+        skip_whitespace();
+        if (position != input.size()) {
+            fail("trailing characters");
+        }
+        return value;
+    }
+
+private:
+    const std::string& input;
+    size_t position = 0;
+
+    [[noreturn]] void fail(const std::string& message) const {
+        throw std::invalid_argument("JSON " + message + " at offset " + std::to_string(position));
+    }
+
+    void skip_whitespace() {
+        while (position < input.size() && std::isspace(static_cast<unsigned char>(input[position]))) {
+            position++;
+        }
+    }
+
+    bool consume(char expected) {
+        skip_whitespace();
+        if (position < input.size() && input[position] == expected) {
+            position++;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char expected) {
+        if (!consume(expected)) {
+            fail(std::string("expected '") + expected + "'");
+        }
+    }
+
+    bool consume_literal(const char* literal) {
+        size_t length = std::strlen(literal);
+        if (input.compare(position, length, literal) == 0) {
+            position += length;
+            return true;
+        }
+        return false;
+    }
+
+    JsonValue parse_value() {
+        skip_whitespace();
+        if (position >= input.size()) {
+            fail("unexpected end");
+        }
+        JsonValue value;
+        char next = input[position];
+        if (next == '{') {
+            value.type = JsonValue::Type::Object;
+            position++;
+            if (!consume('}')) {
+                do {
+                    skip_whitespace();
+                    std::string key = parse_string();
+                    expect(':');
+                    value.members.emplace_back(std::move(key), parse_value());
+                } while (consume(','));
+                expect('}');
+            }
+        } else if (next == '[') {
+            value.type = JsonValue::Type::Array;
+            position++;
+            if (!consume(']')) {
+                do {
+                    value.items.push_back(parse_value());
+                } while (consume(','));
+                expect(']');
+            }
+        } else if (next == '"') {
+            value.type = JsonValue::Type::String;
+            value.text = parse_string();
+        } else if (consume_literal("true")) {
+            value.type = JsonValue::Type::Bool;
+            value.boolean = true;
+        } else if (consume_literal("false")) {
+            value.type = JsonValue::Type::Bool;
+        } else if (consume_literal("null")) {
+            value.type = JsonValue::Type::Null;
+        } else {
+            const char* begin = input.c_str() + position;
+            char* end = nullptr;
+            value.type = JsonValue::Type::Number;
+            value.number = std::strtod(begin, &end);
+            if (end == begin) {
+                fail("unexpected character");
+            }
+            position += end - begin;
+        }
+        return value;
+    }
+
+    std::string parse_string() {
+        if (position >= input.size() || input[position] != '"') {
+            fail("expected string");
+        }
+        position++;
+        std::string text;
+        while (position < input.size() && input[position] != '"') {
+            char c = input[position++];
+            if (c != '\\') {
+                text += c;
+                continue;
+            }
+            if (position >= input.size()) {
+                break;
+            }
+            char escape = input[position++];
+            switch (escape) {
+                case 'n': text += '\n'; break;
+                case 't': text += '\t'; break;
+                case 'r': text += '\r'; break;
+                case 'b': text += '\b'; break;
+                case 'f': text += '\f'; break;
+                case 'u': {
+                    if (position + 4 > input.size()) {
+                        fail("bad unicode escape");
+                    }
+                    unsigned code = std::stoul(input.substr(position, 4), nullptr, 16);
+                    position += 4;
+                    if (code < 0x80) { // Encode as UTF-8; surrogate pairs are passed through unpaired
+                        text += static_cast<char>(code);
+                    } else if (code < 0x800) {
+                        text += static_cast<char>(0xC0 | (code >> 6));
+                        text += static_cast<char>(0x80 | (code & 0x3F));
+                    } else {
+                        text += static_cast<char>(0xE0 | (code >> 12));
+                        text += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                        text += static_cast<char>(0x80 | (code & 0x3F));
+                    }
+                    break;
+                }
+                default: text += escape; break; // \" \\ \/
+            }
+        }
+        if (position >= input.size()) {
+            fail("unterminated string");
+        }
+        position++;
+        return text;
+    }
+};
+
+std::string json_quote(const std::string& text) { // JSON string literal for text
+    std::string quoted = "\"";
+    for (char c : text) {
+        switch (c) {
+            case '"': quoted += "\\\""; break;
+            case '\\': quoted += "\\\\"; break;
+            case '\n': quoted += "\\n"; break;
+            case '\r': quoted += "\\r"; break;
+            case '\t': quoted += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    quoted += escaped;
+                } else {
+                    quoted += c;
+                }
+        }
+    }
+    return quoted + "\"";
+}
+
+std::string json_id(const JsonValue* id) { // Request id echoed back verbatim: a string, a number or null
+    if (!id) {
+        return "null";
+    }
+    if (id->type == JsonValue::Type::String) {
+        return json_quote(id->text);
+    }
+    if (id->type == JsonValue::Type::Number) {
+        std::ostringstream oss;
+        oss << std::setprecision(17) << id->number;
+        return oss.str();
+    }
+    return "null";
+}
+
+int algorithm_from_flag(const std::string& flag) { // Command-line algorithm letter to algorithm_name index; -1 if unknown
+    static const std::vector<std::pair<std::string, int>> flags = {
+        {"", 0}, {"a", 1}, {"i", 2}, {"h", 3}, {"d", 4}, {"b", 5}, {"p", 6}, {"m", 7}, {"e", 8}, {"w", 9}, {"r", 10}, {"x", 11}};
+    for (const auto& [name, choice] : flags) {
+        if (name == flag) {
+            return choice;
+        }
+    }
+    return -1;
+}
+
+const size_t BOARD_CACHE_CAPACITY = 256; // Boards kept across server requests before the oldest is dropped
+const double MAX_REQUEST_SECONDS = 86400; // Longest max_seconds a server request may ask for
+
+// Boards keyed by layout, shared by every request for that layout. A board is built once even when several
+// requests for it arrive together: later callers wait on the first caller's future.
+class BoardCache {
+public:
+    std::shared_ptr<const Board> get(const std::string& key, const std::function<std::shared_ptr<const Board>()>& build, bool& cached) {
+        std::promise<std::shared_ptr<const Board>> promise;
+        std::shared_future<std::shared_ptr<const Board>> future;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = entries.find(key);
+            cached = it != entries.end();
+            if (cached) {
+                future = it->second;
+            } else {
+                future = promise.get_future().share();
+                entries.emplace(key, future);
+                order.push_back(key);
+                if (order.size() > BOARD_CACHE_CAPACITY) {
+                    entries.erase(order.front());
+                    order.pop_front();
+                }
+            }
+        }
+        if (!cached) {
+            try {
+                promise.set_value(build());
+            } catch (...) {
+                promise.set_exception(std::current_exception());
+                std::lock_guard<std::mutex> lock(mutex);
+                entries.erase(key); // Let a corrected request try again
+            }
+        }
+        return future.get();
+    }
+
+private:
+    std::mutex mutex;
+    std::unordered_map<std::string, std::shared_future<std::shared_ptr<const Board>>> entries;
+    std::deque<std::string> order;
+};
+
+// One client: where its results go and the stop tokens of its unfinished requests, by id. The output is
+// written from worker threads, so each result line goes out whole under write_mutex.
+struct ServerConnection {
+    int output_fd;
+    bool owns_fd;
+    std::mutex write_mutex;
+    std::mutex jobs_mutex;
+    std::condition_variable jobs_done;
+    std::unordered_map<std::string, std::shared_ptr<StopToken>> jobs;
+
+    ServerConnection(int fd, bool owns) : output_fd(fd), owns_fd(owns) {}
+
+    ~ServerConnection() {
+        if (owns_fd) {
+            close(output_fd);
+        }
+    }
+
+    void send(const std::string& line) {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        std::string data = line + "\n";
+        for (size_t written = 0; written < data.size();) {
+            ssize_t result = write(output_fd, data.data() + written, data.size() - written);
+            if (result <= 0) {
+                if (result < 0 && errno == EINTR) {
+                    continue;
+                }
+                return; // Client went away; its remaining results are dropped
+            }
+            written += result;
+        }
+    }
+};
+
+class SolverServer {
+public:
+    explicit SolverServer(int worker_count) {
+        for (int i = 0; i < worker_count; ++i) {
+            workers.emplace_back([this]() { work(); });
+        }
+    }
+
+    ~SolverServer() {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            stopping = true;
+        }
+        queue_ready.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    // Read request lines from input_fd until end of file, then wait for this connection's requests to finish
+    void serve(int input_fd, const std::shared_ptr<ServerConnection>& connection) {
+        std::string pending;
+        char chunk[4096];
+        while (true) {
+            ssize_t count = read(input_fd, chunk, sizeof(chunk));
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count <= 0) {
+                break;
+            }
+            pending.append(chunk, count);
+            size_t line_end;
+            while ((line_end = pending.find('\n')) != std::string::npos) {
+                std::string line = pending.substr(0, line_end);
+                pending.erase(0, line_end + 1);
+                handle_line(line, connection);
+            }
+        }
+        if (!pending.empty()) {
+            handle_line(pending, connection);
+        }
+        std::unique_lock<std::mutex> lock(connection->jobs_mutex);
+        connection->jobs_done.wait(lock, [&]() { return connection->jobs.empty(); });
+    }
+
+    // Accept clients on a Unix domain socket, one reader thread each; runs until the process is killed
+    void listen_on(const std::string& path) {
+        int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (listener < 0 || path.size() >= sizeof(address.sun_path)) {
+            throw std::runtime_error("Cannot create socket " + path);
+        }
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        unlink(path.c_str());
+        if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(listener, 16) < 0) {
+            throw std::runtime_error("Cannot listen on " + path + ": " + std::strerror(errno));
+        }
+        std::cerr << "Listening on " << path << std::endl;
+        while (true) {
+            int client = accept(listener, nullptr, nullptr);
+            if (client < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(std::string("accept failed: ") + std::strerror(errno));
+            }
+            std::thread([this, client]() {
+                auto connection = std::make_shared<ServerConnection>(client, true);
+                serve(client, connection);
+            }).detach();
+        }
+    }
+
+private:
+    struct Job {
+        std::string id; // As JSON text
+        JsonValue request;
+        std::shared_ptr<ServerConnection> connection;
+        std::shared_ptr<StopToken> stop;
+        std::chrono::steady_clock::time_point queued_at;
+    };
+
+    std::vector<std::thread> workers;
+    std::mutex queue_mutex;
+    std::condition_variable queue_ready;
+    std::deque<Job> queue;
+    bool stopping = false;
+    BoardCache boards;
+
+    static std::string error_line(const std::string& id, const std::string& message) {
+        return "{\"id\": " + id + ", \"status\": \"error\", \"error\": " + json_quote(message) + "}";
+    }
+
+    void handle_line(const std::string& line, const std::shared_ptr<ServerConnection>& connection) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            return;
+        }
+        JsonValue request;
+        try {
+            request = JsonParser(line).parse();
+        } catch (const std::exception& error) {
+            connection->send(error_line("null", error.what()));
+            return;
+        }
+        std::string id = json_id(request.get("id"));
+        const JsonValue* op = request.get("op");
+        if (op && op->text == "cancel") {
+            std::lock_guard<std::mutex> lock(connection->jobs_mutex);
+            auto it = connection->jobs.find(id);
+            if (it == connection->jobs.end()) {
+                connection->send(error_line(id, "no unfinished request with this id"));
+            } else {
+                it->second->cancel();
+            }
+            return;
+        }
+        if (op && op->text != "solve") {
+            connection->send(error_line(id, "unknown op " + op->text));
+            return;
+        }
+
+        auto stop = std::make_shared<StopToken>();
+        {
+            std::lock_guard<std::mutex> lock(connection->jobs_mutex);
+            if (!connection->jobs.emplace(id, stop).second) {
+                connection->send(error_line(id, "a request with this id is still running"));
+                return;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            queue.push_back({id, std::move(request), connection, stop, std::chrono::steady_clock::now()});
+        }
+        queue_ready.notify_one();
+    }
+
+    void work() {
+        while (true) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(queue_mutex);
+                queue_ready.wait(lock, [&]() { return stopping || !queue.empty(); });
+                if (queue.empty()) {
+                    return;
+                }
+                job = std::move(queue.front());
+                queue.pop_front();
+            }
+            std::string result;
+            try {
+                result = solve(job);
+            } catch (const std::exception& error) {
+                result = error_line(job.id, error.what());
+            }
+            job.connection->send(result);
+            std::lock_guard<std::mutex> lock(job.connection->jobs_mutex);
+            job.connection->jobs.erase(job.id);
+            job.connection->jobs_done.notify_all();
+        }
+    }
+
+    // A request field that must be a number in [low, high], and a whole one if integral
+    static double read_number(const JsonValue& value, const std::string& name, double low, double high, bool integral) {
+        if (value.type != JsonValue::Type::Number || value.number < low || value.number > high ||
+            (integral && value.number != std::floor(value.number))) {
+            std::ostringstream message;
+            message << name << " must be " << (integral ? "an integer" : "a number") << " from " << std::setprecision(integral ? 0 : 6)
+                    << (integral ? std::fixed : std::defaultfloat) << low << " to " << high;
+            throw std::invalid_argument(message.str());
+        }
+        return value.number;
+    }
+
+    static std::vector<Position> read_positions(const JsonValue& request, const char* key, int rows, int cols) {
+        std::vector<Position> positions;
+        const JsonValue* list = request.get(key);
+        if (!list) {
+            return positions;
+        }
+        if (list->type != JsonValue::Type::Array) {
+            throw std::invalid_argument(std::string(key) + " must be a list of [row, col] pairs");
+        }
+        for (const auto& item : list->items) {
+            if (item.type != JsonValue::Type::Array || item.items.size() != 2) {
+                throw std::invalid_argument(std::string(key) + " entries must be [row, col] pairs");
+            }
+            positions.emplace_back(static_cast<int>(read_number(item.items[0], std::string(key) + " rows", 0, rows - 1, true)),
+                                   static_cast<int>(read_number(item.items[1], std::string(key) + " columns", 0, cols - 1, true)));
+        }
+        return positions;
+    }
+
+    std::string solve(const Job& job) {
+        auto started_at = std::chrono::steady_clock::now();
+        std::chrono::duration<double> queue_time = started_at - job.queued_at;
+        const JsonValue& request = job.request;
+
+        const JsonValue* algorithm_field = request.get("algorithm");
+        if (algorithm_field && algorithm_field->type != JsonValue::Type::String) {
+            throw std::invalid_argument("algorithm must be a string");
+        }
+        int algorithm_choice = algorithm_from_flag(algorithm_field ? algorithm_field->text : "");
+        if (algorithm_choice < 0) {
+            throw std::invalid_argument("unknown algorithm " + algorithm_field->text);
+        }
+        const JsonValue* rows = request.get("rows");
+        const JsonValue* cols = request.get("cols");
+        const JsonValue* sentence = request.get("sentence");
+        if (!rows || !cols || !sentence) {
+            throw std::invalid_argument("rows, cols and sentence are required");
+        }
+        if (sentence->type != JsonValue::Type::String) {
+            throw std::invalid_argument("sentence must be a string");
+        }
+        int row_count = static_cast<int>(read_number(*rows, "rows", 1, MAX_CELLS, true));
+        int col_count = static_cast<int>(read_number(*cols, "cols", 1, MAX_CELLS, true));
+        if (row_count * col_count > MAX_CELLS) {
+            throw std::invalid_argument("the grid must have at most " + std::to_string(MAX_CELLS) + " cells");
+        }
+        const JsonValue* level_field = request.get("level");
+        int level_number = level_field ? static_cast<int>(read_number(*level_field, "level", 0, std::numeric_limits<int>::max(), true)) : 0;
+        GameState level(level_number, sentence->text, read_positions(request, "words", row_count, col_count),
+                        read_positions(request, "walls", row_count, col_count), {row_count, col_count});
+        if (level.words.empty() || level.words.size() != level.word_positions.size()) {
+            throw std::invalid_argument("words must give one position per word of the sentence");
+        }
+        for (const auto& position : level.word_positions) {
+            if (level.is_wall(position) || std::count(level.word_positions.begin(), level.word_positions.end(), position) > 1) {
+                throw std::invalid_argument("word positions must be distinct free cells");
+            }
+        }
+
+        const JsonValue* max_seconds = request.get("max_seconds");
+        if (max_seconds && read_number(*max_seconds, "max_seconds", 0, MAX_REQUEST_SECONDS, false) > 0) {
+            job.stop->set_deadline(job.queued_at + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                                       std::chrono::duration<double>(max_seconds->number)));
+        }
+        const JsonValue* max_nodes = request.get("max_nodes");
+        int node_budget = max_nodes ? static_cast<int>(std::min<double>(read_number(*max_nodes, "max_nodes", 0, 1e18, true), MAX_PATHS_TRAVERSED)) : 0;
+
+        // Key on everything a Board is built from except the level number
+        std::ostringstream key;
+        key << level.grid_size.first << 'x' << level.grid_size.second << '|' << level.target_sentence << '|';
+        for (const auto& position : level.word_positions) {
+            key << position.first << ',' << position.second << ';';
+        }
+        key << '|';
+        for (const auto& wall : level.walls) {
+            key << wall.first << ',' << wall.second << ';';
+        }
+        bool board_cached = false;
+        std::shared_ptr<const Board> board;
+        if (!job.stop->stop_requested()) {
+            board = boards.get(key.str(), [&]() { return std::make_shared<const Board>(level); }, board_cached);
+            if (uses_heuristics(algorithm_choice)) {
+                bool heuristics_cached = false;
+                board = boards.get(key.str() + "|pdb", [&]() {
+                    auto with_database = std::make_shared<Board>(*board);
+                    with_database->pattern_database = PatternDatabase::load_or_build(*with_database);
+                    return std::shared_ptr<const Board>(with_database);
+                }, heuristics_cached);
+                board_cached = board_cached && heuristics_cached;
+            }
+        }
+        auto searched_at = std::chrono::steady_clock::now();
+
+        SolveResult result{0, {}};
+        if (board && !job.stop->stop_requested()) {
+            result = run_solver(*board, algorithm_choice, node_budget, job.stop.get());
+        }
+        auto finished_at = std::chrono::steady_clock::now();
+
+        std::string status = solve_status(result, *job.stop, node_budget);
+
+        std::ostringstream line;
+        line << "{\"id\": " << job.id << ", \"status\": \"" << status << "\", \"algorithm\": "
+             << json_quote(algorithm_name(algorithm_choice));
+        if (!result.solution.empty()) {
+            line << ", \"length\": " << result.solution.size() << ", \"moves\": [";
+            for (size_t i = 0; i < result.solution.size(); ++i) {
+                line << (i ? ", " : "") << "[" << json_quote(level.words[result.solution[i].first]) << ", "
+                     << json_quote(result.solution[i].second) << "]";
+            }
+            line << "], \"optimal\": " << (proves_optimality(algorithm_choice) || result.proven_optimal ? "true" : "false");
+        }
+        line << ", \"nodes\": " << result.paths_traversed << std::setprecision(6)
+             << ", \"queue_seconds\": " << queue_time.count()
+             << ", \"setup_seconds\": " << std::chrono::duration<double>(searched_at - started_at).count()
+             << ", \"solve_seconds\": " << std::chrono::duration<double>(finished_at - searched_at).count()
+             << ", \"board_cached\": " << (board_cached ? "true" : "false") << ", \"stats\": " << result.stats.to_json(true) << "}";
+        return line.str();
+    }
+};
+
+// ---------------------------------------------------------------------------------------------------------------
+// Benchmark mode ("bench"): every solver on every level of import and import2 under fixed node and time budgets,
+// written to a JSON file. Each run gets a fresh process pinned to one CPU, with the parallel solvers limited to
+// one thread, so its timings and peak RSS are its own. Reference lengths come from the level lists in
+// wordcraft.html: minMoves is a proven optimum, knownMinMoves the best length known. "baseline=<file>" compares
+// the new results against an earlier file, and "compare=<file>" compares two saved files without running.
+// ---------------------------------------------------------------------------------------------------------------
+
+const int BENCH_NODE_BUDGET = 1000000; // Expansions each benchmark run may use
+const double BENCH_TIME_BUDGET_SECONDS = 20; // Wall-clock budget of each benchmark run
+const int BENCH_ALGORITHMS = 12; // Benchmarks algorithm_name indices 0 to 11
+const double BENCH_REGRESSION_TOLERANCE = 0.10; // Relative change that compare reports as a regression
+const double BENCH_MIN_TIMED_SECONDS = 0.05; // Runs shorter than this are too noisy to compare rates or times
+const char* const BENCH_REFERENCE_FILE = "wordcraft.html";
+
+struct BenchLevelFile {
+    const char* file;
+    Position grid_size;
+    const char* reference_list; // Level list in wordcraft.html the file was exported from
+};
+
+const std::array<BenchLevelFile, 2> BENCH_LEVEL_FILES = {{{"import", {8, 8}, "easyLevels"}, {"import2", {10, 10}, "hardLevels"}}};
+
+struct ReferenceLength {
+    std::string sentence;
+    int moves = 0; // 0 if unknown
+    bool proven = false; // minMoves rather than knownMinMoves
+};
+
+// Entries of "const <list_name> = [ ... ];" in the game, one { sentence: "...", seed: n, minMoves: n } per line
+std::vector<ReferenceLength> load_reference_lengths(const std::string& html_file, const std::string& list_name) {
+    std::ifstream file(html_file);
+    std::vector<ReferenceLength> references;
+    std::string line;
+    bool in_list = false;
+    while (std::getline(file, line)) {
+        if (!in_list) {
+            in_list = line.find("const " + list_name + " = [") != std::string::npos;
+            continue;
+        }
+        if (line.find("];") != std::string::npos) {
+            break;
+        }
+        size_t sentence_start = line.find("sentence: \"");
+        if (sentence_start == std::string::npos) {
+            continue;
+        }
+        sentence_start += 11;
+        ReferenceLength reference;
+        reference.sentence = line.substr(sentence_start, line.find('"', sentence_start) - sentence_start);
+        size_t known = line.find("knownMinMoves:");
+        size_t proven = line.find(" minMoves:");
+        if (known != std::string::npos) {
+            reference.moves = std::stoi(line.substr(known + 14));
+        } else if (proven != std::string::npos) {
+            reference.moves = std::stoi(line.substr(proven + 10));
+            reference.proven = reference.moves > 0; // The game uses 0 for levels nobody has solved optimally
+        }
+        references.push_back(reference);
+    }
+    return references;
+}
+
+void pin_to_one_cpu() { // Keep a benchmark run on the first CPU it may use, so runs do not migrate between cores
+#ifdef __linux__
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return;
+    }
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &allowed)) {
+            cpu_set_t pinned;
+            CPU_ZERO(&pinned);
+            CPU_SET(cpu, &pinned);
+            sched_setaffinity(0, sizeof(pinned), &pinned);
+            return;
+        }
+    }
+#endif
+}
+
+// Solve one level with one solver in a forked child. Returns the run's JSON members, without braces.
+std::string run_benchmark(const GameState& level, int algorithm_choice, int node_budget, double time_budget) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        throw std::runtime_error("cannot create a pipe: " + std::string(std::strerror(errno)));
+    }
+    std::cout.flush();
+    pid_t child = fork();
+    if (child < 0) {
+        throw std::runtime_error("cannot fork: " + std::string(std::strerror(errno)));
+    }
+    if (child == 0) {
+        close(fds[0]);
+        pin_to_one_cpu();
+        std::cout.rdbuf(nullptr); // Drop solver progress; only the record goes back to the parent
+        Board board(level);
+        if (uses_heuristics(algorithm_choice)) { // Loaded or built before the clock starts
+            board.pattern_database = PatternDatabase::load_or_build(board);
+        }
+        StopToken stop;
+        auto started_at = std::chrono::steady_clock::now();
+        stop.set_deadline(started_at + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(time_budget)));
+        SolveResult result = run_solver(board, algorithm_choice, node_budget, &stop);
+        auto finished_at = std::chrono::steady_clock::now();
+        const SearchStatsSnapshot& stats = result.stats;
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+
+        double seconds = std::chrono::duration<double>(finished_at - started_at).count();
+        long long generated = stats.generated;
+        std::ostringstream record;
+        record << std::setprecision(6) << "\"algorithm\": " << json_quote(algorithm_name(algorithm_choice))
+               << ", \"status\": \"" << solve_status(result, stop, node_budget) << "\"";
+        if (result.solution.empty()) {
+            record << ", \"length\": null, \"optimal\": false, \"first_solution_seconds\": null";
+        } else {
+            auto first_offered = stop.first_incumbent_time(); // Anytime solvers publish earlier, worse solutions
+            auto first_solution = first_offered.time_since_epoch().count() ? first_offered : finished_at;
+            record << ", \"length\": " << result.solution.size()
+                   << ", \"optimal\": " << (proves_optimality(algorithm_choice) || result.proven_optimal ? "true" : "false")
+                   << ", \"first_solution_seconds\": " << std::chrono::duration<double>(first_solution - started_at).count();
+        }
+        record << ", \"expansions\": " << result.paths_traversed << ", \"generated\": " << generated << ", \"seconds\": " << seconds
+               << ", \"expansions_per_second\": " << (seconds > 0 ? result.paths_traversed / seconds : 0)
+               << ", \"generated_per_second\": " << (seconds > 0 ? generated / seconds : 0)
+               << ", \"peak_rss_kb\": " << usage.ru_maxrss << ", \"table_entries\": " << stats.table_entries
+               << ", \"table_slots\": " << stats.table_slots << ", \"table_load\": ";
+        if (stats.table_slots) {
+            record << static_cast<double>(stats.table_entries) / stats.table_slots;
+        } else {
+            record << "null"; // IDA* and external BFS keep no hash table of their own
+        }
+        record << ", \"stats\": " << stats.to_json(true);
+
+        std::string text = record.str();
+        for (size_t written = 0; written < text.size();) {
+            ssize_t count = write(fds[1], text.data() + written, text.size() - written);
+            if (count <= 0) {
+                _exit(1);
+            }
+            written += count;
+        }
+        _exit(0);
+    }
+
+    close(fds[1]);
+    std::string text;
+    char buffer[4096];
+    ssize_t count;
+    while ((count = read(fds[0], buffer, sizeof(buffer))) > 0) {
+        text.append(buffer, count);
+    }
+    close(fds[0]);
+    int status = 0;
+    waitpid(child, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || text.empty()) {
+        return "\"algorithm\": " + json_quote(algorithm_name(algorithm_choice)) + ", \"status\": \"crashed\"";
+    }
+    return text;
+}
+
+int compare_benchmarks(const std::string& baseline_file, const std::string& current_file);
+
+// Run the benchmark over level_file ("" for every file in BENCH_LEVEL_FILES); returns the process exit status
+int run_benchmarks(const std::string& level_file, int node_budget, double time_budget, const std::string& out_file,
+                   const std::string& baseline_file) {
+    bool any_file = false;
+    std::ostringstream runs;
+    for (const auto& level_file_info : BENCH_LEVEL_FILES) {
+        if (!level_file.empty() && level_file != level_file_info.file) {
+            continue;
+        }
+        any_file = true;
+        auto levels = load_level_data(level_file_info.file);
+        auto references = load_reference_lengths(BENCH_REFERENCE_FILE, level_file_info.reference_list);
+        for (const auto& level : levels) {
+            level->grid_size = level_file_info.grid_size;
+            ReferenceLength reference;
+            if (level->level <= static_cast<int>(references.size()) && references[level->level - 1].sentence == level->target_sentence) {
+                reference = references[level->level - 1];
+            }
+            for (int algorithm_choice = 0; algorithm_choice < BENCH_ALGORITHMS; ++algorithm_choice) {
+                std::string record = run_benchmark(*level, algorithm_choice, node_budget, time_budget);
+                runs << (runs.tellp() > 0 ? ",\n" : "") << "    {\"file\": " << json_quote(level_file_info.file)
+                     << ", \"level\": " << level->level << ", \"sentence\": " << json_quote(level->target_sentence)
+                     << ", \"reference_moves\": " << (reference.moves ? std::to_string(reference.moves) : "null")
+                     << ", \"reference_proven\": " << (reference.proven ? "true" : "false") << ", " << record << "}";
+
+                std::string object = "{" + record + "}";
+                JsonValue parsed = JsonParser(object).parse();
+                const JsonValue* length = parsed.get("length");
+                const JsonValue* expansions = parsed.get("expansions");
+                const JsonValue* seconds = parsed.get("seconds");
+                std::cout << level_file_info.file << " level " << level->level << ", " << algorithm_name(algorithm_choice) << ": "
+                          << parsed.get("status")->text;
+                if (length && length->type == JsonValue::Type::Number) {
+                    std::cout << ", " << length->number << " moves (reference " << (reference.moves ? std::to_string(reference.moves) : "-") << ")";
+                }
+                if (expansions && seconds) {
+                    std::cout << ", " << static_cast<long long>(expansions->number) << " expansions, " << seconds->number << " s";
+                }
+                std::cout << std::endl;
+            }
+        }
+    }
+    if (!any_file) {
+        std::cerr << "Unknown level file " << level_file << std::endl;
+        return 2;
+    }
+
+    std::ofstream out(out_file);
+    out << "{\"node_budget\": " << node_budget << ", \"time_budget_seconds\": " << time_budget << ", \"runs\": [\n" << runs.str() << "\n]}\n";
+    out.close();
+    if (!out) {
+        std::cerr << "Cannot write " << out_file << std::endl;
+        return 2;
+    }
+    std::cout << "Benchmark results written to " << out_file << std::endl;
+    return baseline_file.empty() ? 0 : compare_benchmarks(baseline_file, out_file);
+}
+
+// Report every run of current_file that got worse than the same file, level and solver in baseline_file: it no
+// longer solves the level, finds a longer solution, expands more nodes, or is slower or larger by more than the
+// tolerance. Returns 1 if anything regressed.
+int compare_benchmarks(const std::string& baseline_file, const std::string& current_file) {
+    auto read_runs = [](const std::string& path, std::string& text) {
+        std::ifstream file(path);
+        if (!file) {
+            throw std::runtime_error("cannot read " + path);
+        }
+        text.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        JsonValue document = JsonParser(text).parse();
+        const JsonValue* runs = document.get("runs");
+        if (!runs || runs->type != JsonValue::Type::Array) {
+            throw std::runtime_error(path + " has no runs array");
+        }
+        return runs->items;
+    };
+    auto key = [](const JsonValue& run) {
+        const JsonValue* file = run.get("file");
+        const JsonValue* level = run.get("level");
+        const JsonValue* algorithm = run.get("algorithm");
+        return (file ? file->text : "") + " level " + (level ? std::to_string(static_cast<int>(level->number)) : "?") + ", " +
+               (algorithm ? algorithm->text : "");
+    };
+    auto number = [](const JsonValue& run, const char* name) { // -1 when missing or null
+        const JsonValue* value = run.get(name);
+        return value && value->type == JsonValue::Type::Number ? value->number : -1.0;
+    };
+    auto solved = [](const JsonValue& run) {
+        const JsonValue* status = run.get("status");
+        return status && status->text == "solved";
+    };
+
+    std::string baseline_text, current_text;
+    std::vector<JsonValue> baseline_runs, current_runs;
+    try {
+        baseline_runs = read_runs(baseline_file, baseline_text);
+        current_runs = read_runs(current_file, current_text);
+    } catch (const std::exception& error) {
+        std::cerr << "Cannot compare benchmarks: " << error.what() << std::endl;
+        return 2;
     }
-    
-    // If BFS fails, try A* with 1M paths limit
-    std::cout << "BFS failed, trying A* for Level " << level_data.level << std::endl;
-    auto astar_result = solve_game_astar(level_data, 1000000);
-    
-    // Always try IDA* with 1M paths limit
-    std::cout << "Trying IDA* for Level " << level_data.level << std::endl;
-    auto ida_result = solve_game_ida_star_beam(level_data, 1000000);
-    
-    if (!astar_result.solution.empty() && !ida_result.solution.empty()) {
-        std::cout << "Both A* and IDA* found solutions for Level " << level_data.level << std::endl;
-        size_t shorter_length = std::min(astar_result.solution.size(), ida_result.solution.size());
-        std::cout << "Length of shorter solution: " << shorter_length << std::endl;
-        if (astar_result.solution.size() <= ida_result.solution.size()) {
-            std::cout << "A* solution is shorter or equal. Using A* solution." << std::endl;
-            return astar_result;
-        } else {
-            std::cout << "IDA* solution is shorter. Using IDA* solution." << std::endl;
-            return ida_result;
+    std::unordered_map<std::string, const JsonValue*> baseline_by_key;
+    for (const auto& run : baseline_runs) {
+        baseline_by_key[key(run)] = &run;
+    }
+
+    int regressions = 0;
+    int matched = 0;
+    auto report = [&](const std::string& run_key, const std::string& metric, double before, double after) {
+        regressions++;
+        std::cout << "Regression: " << run_key << ": " << metric << " " << before << " -> " << after << std::endl;
+    };
+    for (const auto& run : current_runs) {
+        auto found = baseline_by_key.find(key(run));
+        if (found == baseline_by_key.end()) {
+            continue;
+        }
+        const JsonValue& base = *found->second;
+        std::string run_key = key(run);
+        matched++;
+        if (solved(base) && !solved(run)) {
+            regressions++;
+            std::cout << "Regression: " << run_key << ": no longer solved (" << run.get("status")->text << ")" << std::endl;
+            continue;
+        }
+        if (solved(base) && solved(run)) {
+            if (number(run, "length") > number(base, "length")) {
+                report(run_key, "solution length", number(base, "length"), number(run, "length"));
+            }
+            if (number(run, "expansions") > number(base, "expansions") * (1 + BENCH_REGRESSION_TOLERANCE)) {
+                report(run_key, "expansions", number(base, "expansions"), number(run, "expansions"));
+            }
+            double base_first = number(base, "first_solution_seconds");
+            double first = number(run, "first_solution_seconds");
+            if (first >= BENCH_MIN_TIMED_SECONDS && base_first >= 0 && first > base_first * (1 + BENCH_REGRESSION_TOLERANCE)) {
+                report(run_key, "time to first solution", base_first, first);
+            }
+        }
+        if (number(base, "seconds") >= BENCH_MIN_TIMED_SECONDS && number(run, "seconds") >= BENCH_MIN_TIMED_SECONDS) {
+            for (const char* rate : {"expansions_per_second", "generated_per_second"}) {
+                if (number(run, rate) < number(base, rate) * (1 - BENCH_REGRESSION_TOLERANCE)) {
+                    report(run_key, rate, number(base, rate), number(run, rate));
+                }
+            }
+        }
+        if (number(run, "peak_rss_kb") > number(base, "peak_rss_kb") * (1 + BENCH_REGRESSION_TOLERANCE)) {
+            report(run_key, "peak RSS (KB)", number(base, "peak_rss_kb"), number(run, "peak_rss_kb"));
         }
-    } else if (!astar_result.solution.empty()) {
-        std::cout << "Only A* found a solution for Level " << level_data.level << std::endl;
-        return astar_result;
-    } else if (!ida_result.solution.empty()) {
-        std::cout << "Only IDA* found a solution for Level " << level_data.level << std::endl;
-        return ida_result;
     }
-    
-    std::cout << "All algorithms failed to find a solution for Level " << level_data.level << std::endl;
-    return {ida_result.paths_traversed + astar_result.paths_traversed + bfs_result.paths_traversed, {}};
+    std::cout << regressions << " regressions in " << matched << " runs matched against " << baseline_file << std::endl;
+    return regressions ? 1 : 0;
 }
 
-void solve_level(const GameState& level_data, int algorithm_choice) {
-    auto [possible_positions, goal_states] = level_data.calculate_possible_positions_and_goal_states();
-    {
+const double WALL_PERCENTAGE_INITIAL = 0.3; // The game's wall density constants; generated layouts must match it exactly
+const double WALL_PERCENTAGE_DECREASE = 0.02;
+const double MIN_WALL_PERCENTAGE = 0.11;
+const int GENERATOR_SEED_CHUNK = 256; // Seeds a sweep worker claims at a time
+const int GENERATOR_FILTER_NODES = 20000; // Expansions of the quick solve, which settles most candidates
+const int GENERATOR_NODE_BUDGET = 2000000; // Expansions of the full solve for candidates the quick one leaves open
+const int GENERATOR_RESULT_COUNT = 10; // Matching seeds a sweep stops after
+
+class Mulberry32 { // The game's seeded generator; unsigned 32-bit arithmetic reproduces its JavaScript bit for bit
+public:
+    explicit Mulberry32(uint32_t seed) : state(seed) {}
+
+    double operator()() {
+        uint32_t t = state += 0x6D2B79F5u;
+        t = (t ^ t >> 15) * (t | 1);
+        t ^= t + (t ^ t >> 7) * (t | 61);
+        return (t ^ t >> 14) / 4294967296.0;
+    }
+
+private:
+    uint32_t state;
+};
+
+// The game's test for a word boxed in along its row or column: the first wall or word met scanning outward is a
+// wall on both sides
+bool is_position_isolated(const GameState& state, const Position& pos) {
+    auto blocked = [&](int row_step, int col_step) {
+        for (Position next = {pos.first + row_step, pos.second + col_step}; !state.is_out_of_bounds(next);
+             next = {next.first + row_step, next.second + col_step}) {
+            if (state.is_wall(next)) {
+                return true;
+            }
+            if (std::find(state.word_positions.begin(), state.word_positions.end(), next) != state.word_positions.end()) {
+                return false;
+            }
+        }
+        return false;
+    };
+    return (blocked(0, -1) && blocked(0, 1)) || (blocked(-1, 0) && blocked(1, 0));
+}
+
+// Port of the game's generateLevel (variant 1) and generateLevel2 (variant 2): the same seed, level and mode give
+// the same layout, in the same order the game exports it. Returns null where the game would throw. generateLevel
+// draws the hard-mode border from the level's generator and, through a bug, never walls the right column;
+// generateLevel2 uses Math.random there, which a second generator seeded from ~seed stands in for.
+std::unique_ptr<GameState> generate_level(const std::string& sentence, uint32_t seed, int level, Position grid_size,
+                                          bool hard_mode, int variant = 1) {
+    auto state = std::make_unique<GameState>(level, sentence, std::vector<Position>(), std::vector<Position>(), grid_size);
+    if (state->words.empty()) {
+        return nullptr;
+    }
+    Mulberry32 rng(seed);
+    int rows = grid_size.first;
+    int cols = grid_size.second;
+    int total_cells = rows * cols;
+    double wall_percentage = level <= 4
+        ? std::max(WALL_PERCENTAGE_INITIAL - (level - 1) * WALL_PERCENTAGE_DECREASE, MIN_WALL_PERCENTAGE)
+        : std::min(WALL_PERCENTAGE_INITIAL + (level - 4) * WALL_PERCENTAGE_DECREASE, WALL_PERCENTAGE_INITIAL);
+    double num_walls = std::floor(total_cells * wall_percentage) * (hard_mode ? 0.5 : 1); // Half a wall still adds one
+
+    if (hard_mode) {
+        Mulberry32 border_rng(~seed);
+        auto border_draw = [&]() { return variant == 2 ? border_rng() : rng(); };
+        for (int i = 0; i < rows; ++i) {
+            if (border_draw() < 0.5) {
+                state->walls.push_back({i, 0});
+            }
+            if (variant == 2 && border_draw() < 0.5) {
+                state->walls.push_back({i, cols - 1});
+            }
+        }
+        for (int j = 0; j < cols; ++j) {
+            if (border_draw() < 0.5) {
+                state->walls.push_back({0, j});
+            }
+            if (border_draw() < 0.5) {
+                state->walls.push_back({rows - 1, j});
+            }
+        }
+    }
+
+    int max_attempts = variant == 2 ? 10000 : 100;
+    auto place = [&](bool avoid_isolation, Position& pos) {
+        for (int attempts = 0; attempts < max_attempts; ++attempts) {
+            pos.first = static_cast<int>(std::floor(rng() * rows));
+            pos.second = static_cast<int>(std::floor(rng() * cols));
+            if (!state->is_position_occupied(pos) && !(avoid_isolation && is_position_isolated(*state, pos))) {
+                return true;
+            }
+        }
+        return false;
+    };
+    Position pos;
+    for (int i = 0; i < num_walls; ++i) {
+        if (!place(false, pos)) {
+            return nullptr;
+        }
+        state->walls.push_back(pos);
+    }
+    for (size_t i = 0; i < state->words.size(); ++i) {
+        if (!place(variant == 1, pos)) {
+            return nullptr;
+        }
+        state->word_positions.push_back(pos);
+    }
+    return state;
+}
+
+struct SeedSweep { // What generate mode looks for
+    std::string sentence;
+    int level = 1; // Sets the wall density, as the level number does in the game
+    Position grid_size = {8, 8};
+    bool hard_mode = false;
+    int variant = 1; // 1 for generateLevel, 2 for generateLevel2
+    uint64_t first_seed = 0;
+    uint64_t last_seed = 999999;
+    int min_length = 15;
+    int max_length = MAX_PATH_LENGTH;
+    int wanted = GENERATOR_RESULT_COUNT;
+    int node_budget = GENERATOR_NODE_BUDGET;
+};
+
+class NullBuffer : public std::streambuf { // Discards everything written through it, from any thread
+protected:
+    int overflow(int c) override {
+        return traits_type::not_eof(c);
+    }
+};
+
+// Sweep seeds for a sentence on worker_count threads and print those whose shortest solution is within
+// [min_length, max_length]. Each candidate gets a quick A* run with a small node budget, which settles the
+// trivial ones and the ones with no short enough solution; only the rest get the full budget. The incumbent of
+// each run starts at max_length + 1, so A* prunes everything longer and runs out of nodes instead of solving them.
+int sweep_seeds(const SeedSweep& sweep, int worker_count) {
+    if (GameState(sweep.level, sweep.sentence, {}, {}, sweep.grid_size).words.size() > static_cast<size_t>(MAX_WORDS)) {
+        std::cerr << "A packed state holds at most " << MAX_WORDS << " words" << std::endl;
+        return 2;
+    }
+    std::ostream results(std::cout.rdbuf());
+    NullBuffer discard;
+    std::cout.rdbuf(&discard); // Solver chatter for millions of candidates is noise; results go out directly
+    use_solution_cache = false;
+
+    std::atomic<uint64_t> next_seed{sweep.first_seed};
+    std::atomic<int> found{0};
+    std::atomic<long long> not_generated{0}, too_short{0}, too_long{0}, undecided{0};
+    std::vector<std::pair<uint64_t, int>> matches;
+    std::mutex matches_mutex;
+    auto start_time = std::chrono::steady_clock::now();
+
+    auto classify = [&](uint64_t seed) {
+        auto level = generate_level(sweep.sentence, static_cast<uint32_t>(seed), sweep.level, sweep.grid_size, sweep.hard_mode, sweep.variant);
+        if (!level) {
+            not_generated++;
+            return;
+        }
+        Board board(*level);
+        for (int budget : {GENERATOR_FILTER_NODES, sweep.node_budget}) {
+            StopToken stop;
+            stop.offer_incumbent(sweep.max_length + 1);
+            SolveResult result = with_word_count(board, [&]<int Words>() { return solve_game_astar<Words>(board, budget, &stop); });
+            if (!result.solution.empty()) {
+                int length = static_cast<int>(result.solution.size());
+                if (length < sweep.min_length) {
+                    too_short++;
+                    return;
+                }
+                std::lock_guard<std::mutex> lock(matches_mutex);
+                if (found < sweep.wanted) {
+                    found++;
+                    matches.push_back({seed, length});
+                    results << "Seed " << seed << ": " << length << " moves (" << result.paths_traversed << " expansions)" << std::endl;
+                }
+                return;
+            }
+            if (result.paths_traversed < budget) { // Ran out of nodes below the bound
+                too_long++;
+                return;
+            }
+            if (budget >= sweep.node_budget) {
+                break;
+            }
+        }
+        undecided++;
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < worker_count; ++t) {
+        workers.emplace_back([&]() {
+            while (found < sweep.wanted) {
+                uint64_t first = next_seed.fetch_add(GENERATOR_SEED_CHUNK);
+                if (first > sweep.last_seed) {
+                    break;
+                }
+                uint64_t last = std::min<uint64_t>(first + GENERATOR_SEED_CHUNK - 1, sweep.last_seed);
+                for (uint64_t seed = first; seed <= last && found < sweep.wanted; ++seed) {
+                    classify(seed);
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    std::cout.rdbuf(results.rdbuf());
+
+    std::sort(matches.begin(), matches.end());
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+    long long examined = not_generated + too_short + too_long + undecided + static_cast<long long>(matches.size());
+    std::cout << examined << " seeds in " << elapsed.count() << " s: " << matches.size() << " within " << sweep.min_length
+              << "-" << sweep.max_length << " moves, " << too_short << " shorter, " << too_long << " longer or unsolvable, "
+              << undecided << " over the node budget, " << not_generated << " not generated" << std::endl;
+    for (const auto& [seed, length] : matches) {
+        std::cout << "{ sentence: " << json_quote(sweep.sentence) << ", seed: " << seed << ", minMoves: " << length << " }," << std::endl;
+    }
+    return matches.empty() ? 1 : 0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------
+// Census mode ("census", or "census=<level>" for one level): enumerates every state reachable from a level's
+// initial layout and writes to census.json ("out=<file>"), per level, the size of each BFS layer, the reachable
+// goal states and the optimal solution length of every reachable state, as a histogram with the hardest state.
+// States are ranked to a dense index over the cells each word can rest in (Board::reachable_cells), and each
+// index holds a two-bit layer mark plus one bit of the reachable set, so no state is ever stored. Layers are
+// found by scanning those bits in chunks spread over workers=<n> threads. A level whose index space does not
+// fit in "memory=<MB>" is reported as skipped.
+// ---------------------------------------------------------------------------------------------------------------
+
+const size_t CENSUS_MEMORY_BUDGET_MB = 3072; // Default cap on the census bit arrays of one level
+const size_t CENSUS_CHUNK_WORDS = 4096; // 64-bit words of the mark array a census worker claims at a time
+const uint64_t CENSUS_LOW_BITS = 0x5555555555555555ULL; // Low bit of every two-bit mark in a 64-bit word
+
+size_t census_memory_budget = CENSUS_MEMORY_BUDGET_MB << 20; // Bytes a census may hold; set by "memory=<MB>"
+
+// Mixed-radix index of a layout in which every word is on one of its reachable cells. The static analysis
+// guarantees every state reachable from the initial layout is such a layout. Indices of layouts with two words
+// on one cell are never reached, which wastes a little of the space but keeps ranking a multiply-add per word.
+class StateRanker {
+public:
+    explicit StateRanker(const Board& board) : board(board) {
+        for (int i = 0; i < board.num_words; ++i) {
+            cell_rank[i].fill(NO_CELL);
+            for (Bitboard cells = board.reachable_cells[i]; cells; cells &= cells - 1) {
+                cell_rank[i][lowest_cell(cells)] = static_cast<uint8_t>(rank_cell[i].size());
+                rank_cell[i].push_back(static_cast<uint8_t>(lowest_cell(cells)));
+            }
+            stride[i] = space;
+            if (__builtin_mul_overflow(space, static_cast<uint64_t>(rank_cell[i].size()), &space)) {
+                space = std::numeric_limits<uint64_t>::max();
+            }
+        }
+    }
+
+    uint64_t size() const { // Number of indices; saturates at the largest uint64_t
+        return space;
+    }
+
+    bool rankable(const PackedState& state) const { // Whether every word is on one of its reachable cells
+        for (int i = 0; i < board.num_words; ++i) {
+            if (cell_rank[i][state.cells[i]] == NO_CELL) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    uint64_t rank(const PackedState& state) const {
+        uint64_t index = 0;
+        for (int i = 0; i < board.num_words; ++i) {
+            index += cell_rank[i][state.cells[i]] * stride[i];
+        }
+        return index;
+    }
+
+    PackedState unrank(uint64_t index) const {
+        std::array<uint8_t, MAX_WORDS> cells{};
+        for (int i = 0; i < board.num_words; ++i) {
+            cells[i] = rank_cell[i][index % rank_cell[i].size()];
+            index /= rank_cell[i].size();
+        }
+        return board.pack_cells(cells.data());
+    }
+
+private:
+    const Board& board;
+    std::array<std::array<uint8_t, MAX_CELLS>, MAX_WORDS> cell_rank{}; // [word][cell] position among its reachable cells
+    std::array<std::vector<uint8_t>, MAX_WORDS> rank_cell; // [word][position] the reachable cell itself
+    std::array<uint64_t, MAX_WORDS> stride{};
+    uint64_t space = 1;
+};
+
+// Two bits per ranked state, read and marked concurrently by the census workers. A state is FREE until a layer
+// reaches it, NEXT while that layer is being built, CURRENT while it is expanded and DONE after.
+class LayerMarks {
+public:
+    enum Mark : uint64_t { FREE = 0, CURRENT = 1, NEXT = 2, DONE = 3 };
+
+    explicit LayerMarks(uint64_t size) : words(size / 32 + 1, 0) {}
+
+    size_t word_count() const {
+        return words.size();
+    }
+
+    Mark get(uint64_t index) const {
+        return static_cast<Mark>(load(index / 32) >> (index % 32 * 2) & 3);
+    }
+
+    void set(uint64_t index, Mark mark) { // Single-threaded use only
+        words[index / 32] = (words[index / 32] & ~(uint64_t(3) << (index % 32 * 2))) | (uint64_t(mark) << (index % 32 * 2));
+    }
+
+    bool mark_next(uint64_t index) { // FREE -> NEXT; true for the one caller that made the change
+        if (get(index) != FREE) {
+            return false;
+        }
+        uint64_t bit = uint64_t(NEXT) << (index % 32 * 2);
+        uint64_t old = std::atomic_ref<uint64_t>(words[index / 32]).fetch_or(bit, std::memory_order_relaxed);
+        return (old >> (index % 32 * 2) & 3) == FREE;
+    }
+
+    uint64_t current_bits(size_t word) const { // Low bit of every CURRENT mark in a word
+        uint64_t value = load(word);
+        return value & ~(value >> 1) & CENSUS_LOW_BITS;
+    }
+
+    uint32_t reached_bits(size_t word) const { // One bit per mark of a word that is not FREE, in index order
+        uint64_t value = load(word);
+        uint64_t bits = (value | value >> 1) & CENSUS_LOW_BITS;
+        bits = (bits | bits >> 1) & 0x3333333333333333ULL;
+        bits = (bits | bits >> 2) & 0x0F0F0F0F0F0F0F0FULL;
+        bits = (bits | bits >> 4) & 0x00FF00FF00FF00FFULL;
+        bits = (bits | bits >> 8) & 0x0000FFFF0000FFFFULL;
+        return static_cast<uint32_t>(bits | bits >> 16);
+    }
+
+    void advance(size_t word) { // CURRENT -> DONE and NEXT -> CURRENT; DONE and FREE stay
+        uint64_t value = load(word);
+        std::atomic_ref<uint64_t>(words[word]).store(((value & CENSUS_LOW_BITS) << 1) | ((value | value >> 1) & CENSUS_LOW_BITS),
+                                                     std::memory_order_relaxed);
+    }
+
+    void clear() {
+        std::fill(words.begin(), words.end(), 0);
+    }
+
+private:
+    uint64_t load(size_t word) const { // Other workers may be setting NEXT bits of the same word with mark_next
+        return std::atomic_ref<const uint64_t>(words[word]).load(std::memory_order_relaxed);
+    }
+
+    std::vector<uint64_t> words;
+};
+
+struct CensusResult {
+    bool complete = false; // False if the level was skipped for its memory
+    uint64_t index_space = 0;
+    size_t memory_bytes = 0; // Held by the census, or needed by a skipped one
+    std::vector<long long> layers; // States first reached at each depth from the initial layout
+    long long reachable = 0;
+    long long goal_states = 0;
+    std::vector<long long> distances; // Reachable states by optimal solution length
+    long long unsolvable = 0; // Reachable states from which no goal can be reached
+    int initial_distance = -1;
+    PackedState hardest{}; // A reachable state with the longest optimal solution, lowest index first
+    double seconds = 0;
+};
+
+// Layer-by-layer BFS over marks from the states marked CURRENT, through expand(state, mark) which marks a state's
+// neighbours NEXT. Returns the size of every layer, the first included; after_layer runs once each new layer is
+// CURRENT. The last layer is left marked CURRENT, everything before it DONE.
+template <typename Expand, typename AfterLayer>
+std::vector<long long> census_layers(const StateRanker& ranker, LayerMarks& marks, long long first_layer, int thread_count,
+                                     Expand&& expand, AfterLayer&& after_layer) {
+    std::vector<long long> layers = {first_layer};
+    while (layers.back() > 0) {
+        std::atomic<size_t> next_chunk{0};
+        std::atomic<long long> reached{0};
+        auto worker = [&]() {
+            long long counted = 0;
+            auto mark = [&](const PackedState& state) {
+                counted += marks.mark_next(ranker.rank(state));
+            };
+            for (size_t begin = next_chunk.fetch_add(CENSUS_CHUNK_WORDS); begin < marks.word_count();
+                 begin = next_chunk.fetch_add(CENSUS_CHUNK_WORDS)) {
+                size_t end = std::min(begin + CENSUS_CHUNK_WORDS, marks.word_count());
+                for (size_t word = begin; word < end; ++word) {
+                    for (uint64_t bits = marks.current_bits(word); bits; bits &= bits - 1) {
+                        expand(ranker.unrank(word * 32 + std::countr_zero(bits) / 2), mark);
+                    }
+                }
+            }
+            reached += counted;
+        };
+        std::vector<std::thread> workers;
+        for (int t = 1; t < thread_count; ++t) {
+            workers.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : workers) {
+            thread.join();
+        }
+        if (reached == 0) {
+            break;
+        }
+        for (size_t word = 0; word < marks.word_count(); ++word) {
+            marks.advance(word);
+        }
+        after_layer(static_cast<int>(layers.size()), reached.load());
+        layers.push_back(reached);
+    }
+    if (layers.back() == 0) {
+        layers.pop_back();
+    }
+    return layers;
+}
+
+// Enumerate the states reachable from board.initial, then walk back from the reachable goal states over the
+// reverse moves, restricted to reachable states, for every state's optimal solution length
+CensusResult run_census(const Board& board, size_t memory_budget, int thread_count) {
+    auto start_time = std::chrono::steady_clock::now();
+    CensusResult result;
+    StateRanker ranker(board);
+    result.index_space = ranker.size();
+    uint64_t words = ranker.size() / 32 + 1; // Of the marks, and of the reachable bitmap at half their size
+    result.memory_bytes = words * (sizeof(uint64_t) + sizeof(uint32_t));
+    if (result.memory_bytes > memory_budget) {
+        return result;
+    }
+    result.complete = true;
+
+    auto report = [&](const char* pass, int depth, long long states) {
         std::lock_guard<std::mutex> lock(cout_mutex);
-        std::cout << "Solving Level " << level_data.level << std::endl;
-        std::cout << "Possible positions for sentence: " << possible_positions << std::endl;
+        std::cout << "Level " << board.level << ": census " << pass << " depth " << depth << ", " << states << " states" << std::endl;
+    };
+
+    LayerMarks marks(ranker.size());
+    marks.set(ranker.rank(board.initial), LayerMarks::CURRENT);
+    result.layers = census_layers(ranker, marks, 1, thread_count, [&](const PackedState& state, auto& mark) {
+        std::array<PackedState, MAX_WORDS * NUM_DIRECTIONS> successors;
+        int successor_count = board.generate_successors(state, successors);
+        for (int move = 0; move < successor_count; ++move) {
+            mark(successors[move]);
+        }
+    }, [&](int depth, long long states) { report("forward", depth, states); });
+    for (long long layer : result.layers) {
+        result.reachable += layer;
     }
 
-    auto start = std::chrono::high_resolution_clock::now();
-    SolveResult result;
-    
-    if (algorithm_choice == 0) {
-        result = solve_game_bfs(level_data);
-    } else if (algorithm_choice == 1) {
-        result = solve_game_astar(level_data);
-    } else if (algorithm_choice == 2) {
-        result = solve_game_ida_star_beam(level_data);
-    } else {
-        result = solve_level_hybrid(level_data);
+    std::vector<uint32_t> reachable(marks.word_count()); // One bit per index, set for every reached state
+    for (size_t word = 0; word < marks.word_count(); ++word) {
+        reachable[word] = marks.reached_bits(word);
     }
-    
-    auto solution = result.solution;
-    auto paths_traversed = result.paths_traversed;
-    auto end = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double> time_taken = end - start;
+    auto is_reachable = [&](const PackedState& state) {
+        if (!ranker.rankable(state)) {
+            return false;
+        }
+        uint64_t index = ranker.rank(state);
+        return (reachable[index / 32] >> (index % 32) & 1) != 0;
+    };
 
-    std::lock_guard<std::mutex> lock(cout_mutex);
-    if (!solution.empty()) {
-        std::cout << "Solution for Level " << level_data.level << " (" 
-                  << (algorithm_choice == 0 ? "BFS" : (algorithm_choice == 1 ? "A*" : "IDA* with Beam Search")) << "): ";
-        for (const auto& move : solution) {
-            std::cout << "(" << level_data.words[move.first] << ", " << move.second << ") ";
+    marks.clear();
+    for (const auto& goal_state : board.goal_states) {
+        if (is_reachable(goal_state)) {
+            marks.set(ranker.rank(goal_state), LayerMarks::CURRENT);
+            result.goal_states++;
         }
-        std::cout << std::endl;
-        std::cout << "Minimum moves for Level " << level_data.level << ": " << solution.size() << std::endl;
-        std::cout << "Time taken for Level " << level_data.level << ": " << time_taken.count() << " seconds" << std::endl;
-        std::cout << "Paths traversed for Level " << level_data.level << ": " << paths_traversed << std::endl;
-    } else {
-        std::cout << "No solution found for Level " << level_data.level << " (" 
-                  << (algorithm_choice == 0 ? "BFS" : "A*") << ")" << std::endl;
-        std::cout << "Paths traversed for Level " << level_data.level << ": " << paths_traversed << std::endl;
     }
-    std::cout << std::endl;
+    uint64_t initial_index = ranker.rank(board.initial);
+    if (marks.get(initial_index) == LayerMarks::CURRENT) {
+        result.initial_distance = 0;
+    }
+    result.distances = census_layers(ranker, marks, result.goal_states, thread_count, [&](const PackedState& state, auto& mark) {
+        thread_local std::vector<std::pair<PackedState, uint8_t>> predecessors;
+        predecessors.clear();
+        board.generate_predecessors(state, predecessors);
+        for (const auto& [predecessor, move] : predecessors) {
+            if (is_reachable(predecessor)) {
+                mark(predecessor);
+            }
+        }
+    }, [&](int depth, long long states) {
+        if (result.initial_distance < 0 && marks.get(initial_index) == LayerMarks::CURRENT) {
+            result.initial_distance = depth;
+        }
+        report("backward", depth, states);
+    });
+    long long solvable = 0;
+    for (long long count : result.distances) {
+        solvable += count;
+    }
+    result.unsolvable = result.reachable - solvable;
+
+    // The last backward layer is left marked CURRENT; its lowest index is the reported hardest state
+    for (size_t word = 0; word < marks.word_count(); ++word) {
+        if (uint64_t bits = marks.current_bits(word)) {
+            result.hardest = ranker.unrank(word * 32 + std::countr_zero(bits) / 2);
+            break;
+        }
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    return result;
 }
 
+// Census of every level of csv_file, or of only_level if it is non-zero; returns the process exit status
+int run_census_file(const std::string& csv_file, Position grid_size, int only_level, int thread_count, const std::string& out_file) {
+    std::ostringstream records;
+    for (const auto& level : load_level_data(csv_file)) {
+        if (only_level && level->level != only_level) {
+            continue;
+        }
+        level->grid_size = grid_size;
+        Board board(*level);
+        CensusResult census = run_census(board, census_memory_budget, thread_count);
+
+        std::ostringstream record;
+        record << "    {\"level\": " << level->level << ", \"sentence\": " << json_quote(level->target_sentence)
+               << ", \"words\": " << board.num_words << ", \"status\": " << (census.complete ? "\"complete\"" : "\"skipped\"")
+               << ", \"index_space\": " << census.index_space << ", \"memory_bytes\": " << census.memory_bytes;
+        if (!census.complete) {
+            std::cout << "Level " << level->level << ": census skipped, " << census.index_space << " indices need "
+                      << census.memory_bytes / (1 << 20) << " MB of " << census_memory_budget / (1 << 20) << " MB" << std::endl;
+        } else {
+            auto json_list = [](const std::vector<long long>& values) {
+                std::ostringstream list;
+                list << "[";
+                for (size_t i = 0; i < values.size(); ++i) {
+                    list << (i ? ", " : "") << values[i];
+                }
+                list << "]";
+                return list.str();
+            };
+            int hardest_distance = static_cast<int>(census.distances.size()) - 1;
+            record << ", \"reachable\": " << census.reachable << ", \"goal_states\": " << census.goal_states
+                   << ", \"depth\": " << census.layers.size() - 1 << ", \"layers\": " << json_list(census.layers)
+                   << ", \"initial_distance\": " << (census.initial_distance < 0 ? "null" : std::to_string(census.initial_distance))
+                   << ", \"hardest_distance\": " << (hardest_distance < 0 ? "null" : std::to_string(hardest_distance))
+                   << ", \"hardest_start\": ";
+            if (hardest_distance < 0) {
+                record << "null";
+            } else {
+                record << "[";
+                for (int i = 0; i < board.num_words; ++i) {
+                    Position position = board.position(census.hardest.cells[i]);
+                    record << (i ? ", " : "") << "[" << position.first << ", " << position.second << "]";
+                }
+                record << "]";
+            }
+            record << ", \"unsolvable\": " << census.unsolvable << ", \"distances\": " << json_list(census.distances)
+                   << ", \"seconds\": " << census.seconds;
+            std::cout << "Level " << level->level << ": " << census.reachable << " reachable states, " << census.goal_states
+                      << " goal states, depth " << census.layers.size() - 1 << ", hardest start "
+                      << (hardest_distance < 0 ? "-" : std::to_string(hardest_distance)) << " moves, " << census.seconds << " s" << std::endl;
+        }
+        record << "}";
+        records << (records.tellp() > 0 ? ",\n" : "") << record.str();
+    }
+
+    std::ofstream out(out_file);
+    out << "{\"file\": " << json_quote(csv_file) << ", \"levels\": [\n" << records.str() << "\n]}\n";
+    out.close();
+    if (!out) {
+        std::cerr << "Cannot write " << out_file << std::endl;
+        return 2;
+    }
+    std::cout << "Census written to " << out_file << std::endl;
+    return 0;
+}
 
 int main(int argc, char* argv[]) {
     std::string csv_file = "import";
     Position grid_size = {8, 8};
-    int algorithm_choice = 0; // 0 for BFS, 1 for A*, 2 for IDA* with Beam Search, 3 for Hybrid
+    int algorithm_choice = 0; // 0 for BFS, 1 for A*, 2 for IDA* with Beam Search, 3 for Hybrid, 4 for IDA*, 5 for Bidirectional BFS, 6 for Parallel BFS, 7 for Parallel A*, 8 for External BFS, 9 for ARA*, 10 for Portfolio, 11 for SMA*
     bool sequential_solve = false; // New flag for sequential solving
+    bool serve_mode = false; // "serve" answers JSON-lines requests on stdin, "serve=<path>" on a Unix socket
+    std::string socket_path;
+    int worker_count = std::max(1u, std::thread::hardware_concurrency());
+    bool bench_mode = false; // "bench" benchmarks every level file, "bench=<file>" just one
+    std::string bench_file;
+    std::string bench_out = "bench.json";
+    std::string bench_baseline;
+    std::string compare_file;
+    int bench_nodes = BENCH_NODE_BUDGET;
+    double bench_seconds = BENCH_TIME_BUDGET_SECONDS;
+    bool generate_mode = false; // "generate=<sentence>" sweeps seeds for a level of a given difficulty
+    bool census_mode = false; // "census" enumerates every level's reachable states, "census=<level>" just one level's
+    int census_level = 0;
+    std::string census_out = "census.json";
+    SeedSweep sweep;
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
         if (arg == "a")
@@ -690,14 +5521,127 @@ int main(int argc, char* argv[]) {
             algorithm_choice = 2;
         if (arg == "h")
             algorithm_choice = 3;
+        if (arg == "d")
+            algorithm_choice = 4;
+        if (arg == "b")
+            algorithm_choice = 5;
+        if (arg == "p")
+            algorithm_choice = 6;
+        if (arg == "m")
+            algorithm_choice = 7;
+        if (arg == "e")
+            algorithm_choice = 8;
+        if (arg == "w")
+            algorithm_choice = 9;
+        if (arg == "r")
+            algorithm_choice = 10;
+        if (arg == "x")
+            algorithm_choice = 11;
         if (arg == "2") {
             csv_file = "import2";
             grid_size = {10, 10};
+            sweep.grid_size = grid_size;
+            sweep.hard_mode = true;
         }
         if (arg == "s")
             sequential_solve = true;
+        if (arg == "n")
+            use_move_pruning = false;
+        if (arg == "c")
+            use_solution_cache = false;
+        if (arg == "serve")
+            serve_mode = true;
+        if (arg.rfind("serve=", 0) == 0) {
+            serve_mode = true;
+            socket_path = arg.substr(6);
+        }
+        if (arg.rfind("workers=", 0) == 0)
+            worker_count = std::max(1, std::stoi(arg.substr(8)));
+        if (arg == "bench")
+            bench_mode = true;
+        if (arg.rfind("bench=", 0) == 0) {
+            bench_mode = true;
+            bench_file = arg.substr(6);
+        }
+        if (arg.rfind("out=", 0) == 0) {
+            bench_out = arg.substr(4);
+            census_out = bench_out;
+        }
+        if (arg.rfind("baseline=", 0) == 0)
+            bench_baseline = arg.substr(9);
+        if (arg.rfind("compare=", 0) == 0)
+            compare_file = arg.substr(8);
+        if (arg.rfind("nodes=", 0) == 0) {
+            bench_nodes = std::max(1, std::stoi(arg.substr(6)));
+            sweep.node_budget = bench_nodes;
+        }
+        if (arg.rfind("seconds=", 0) == 0)
+            bench_seconds = std::stod(arg.substr(8));
+        if (arg.rfind("generate=", 0) == 0) {
+            generate_mode = true;
+            sweep.sentence = arg.substr(9);
+        }
+        if (arg.rfind("level=", 0) == 0)
+            sweep.level = std::max(1, std::stoi(arg.substr(6)));
+        if (arg.rfind("generator=", 0) == 0)
+            sweep.variant = std::stoi(arg.substr(10)) == 2 ? 2 : 1;
+        if (arg.rfind("seeds=", 0) == 0) {
+            std::string range = arg.substr(6);
+            size_t dash = range.find('-');
+            sweep.first_seed = std::stoull(range.substr(0, dash));
+            sweep.last_seed = dash == std::string::npos ? sweep.first_seed : std::stoull(range.substr(dash + 1));
+        }
+        if (arg.rfind("min=", 0) == 0)
+            sweep.min_length = std::stoi(arg.substr(4));
+        if (arg.rfind("max=", 0) == 0)
+            sweep.max_length = std::stoi(arg.substr(4));
+        if (arg.rfind("count=", 0) == 0)
+            sweep.wanted = std::max(1, std::stoi(arg.substr(6)));
+        if (arg.rfind("memory=", 0) == 0) {
+            sma_memory_budget = static_cast<size_t>(std::max(1, std::stoi(arg.substr(7)))) << 20;
+            census_memory_budget = sma_memory_budget;
+        }
+        if (arg == "census")
+            census_mode = true;
+        if (arg.rfind("census=", 0) == 0) {
+            census_mode = true;
+            census_level = std::stoi(arg.substr(7));
+        }
+    }
+
+    if (generate_mode) {
+        return sweep_seeds(sweep, worker_count);
+    }
+
+    if (census_mode) {
+        return run_census_file(csv_file, grid_size, census_level, worker_count, census_out);
+    }
+
+    if (bench_mode) {
+        use_solution_cache = false; // Every run must search
+        solver_thread_count = 1;
+        return run_benchmarks(bench_file, bench_nodes, bench_seconds, bench_out, bench_baseline);
+    }
+    if (!compare_file.empty()) {
+        return compare_benchmarks(compare_file, bench_out);
+    }
+
+    if (serve_mode) {
+        std::signal(SIGPIPE, SIG_IGN); // A client hanging up must not kill the server
+        if (socket_path.empty()) {
+            std::cout.rdbuf(std::cerr.rdbuf()); // Solver progress goes to stderr; stdout carries only results
+        }
+        StatsReporter reporter(STATS_REPORT_INTERVAL_SECONDS);
+        SolverServer server(worker_count);
+        if (socket_path.empty()) {
+            server.serve(STDIN_FILENO, std::make_shared<ServerConnection>(STDOUT_FILENO, false));
+        } else {
+            server.listen_on(socket_path);
+        }
+        return 0;
     }
 
+    StatsReporter reporter(STATS_REPORT_INTERVAL_SECONDS);
     auto levels = load_level_data(csv_file);
 
     // Update grid size for all levels
@@ -709,7 +5653,9 @@ int main(int argc, char* argv[]) {
         // Solve levels sequentially
         for (const auto& level_data : levels) {
             if (algorithm_choice == 3) {
-                auto result = solve_level_hybrid(*level_data);
+                Board board(*level_data);
+                board.pattern_database = PatternDatabase::load_or_build(board);
+                auto result = run_solver(board, 3);
                 std::cout << "Hybrid solution for Level " << level_data->level << ": ";
                 for (const auto& move : result.solution) {
                     std::cout << "(" << level_data->words[move.first] << ", " << move.second << ") ";
@@ -726,7 +5672,9 @@ int main(int argc, char* argv[]) {
         for (const auto& level_data : levels) {
             futures.push_back(std::async(std::launch::async, [&level_data, algorithm_choice]() {
                 if (algorithm_choice == 3) {
-                    auto result = solve_level_hybrid(*level_data);
+                    Board board(*level_data);
+                    board.pattern_database = PatternDatabase::load_or_build(board);
+                    auto result = run_solver(board, 3);
                     std::lock_guard<std::mutex> lock(cout_mutex);
                     std::cout << "Hybrid solution for Level " << level_data->level << ": ";
                     for (const auto& move : result.solution) {